@@ -0,0 +1,198 @@
+#include "../common/functions.h"
+#include <pthread.h>
+
+//Two-sided 95% quantiles of the Student t distribution for 1 to 30 degrees of freedom. The normal quantile 1.96 is used above 30.
+static const double t_quantiles[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                       2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                       2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+/*
+    Data shared by the threads of the campaign. Realization r uses the stream r of the generator, so the results do not depend on the number of threads.
+    The results of realization r of algorithm a are stored at index r of the arrays of a; each realization is written by one thread only.
+*/
+typedef struct campaign_struct
+{
+    task_set_struct *task_set;
+    allocation_struct *allocation;
+    rng_struct rng;
+    int num_realizations;
+    int next_realization;
+    int *completed[NUM_ALGORITHMS];
+    double *energy[NUM_ALGORITHMS];
+    double *shutdown_time[NUM_ALGORITHMS];
+    double *discarded_ratio[NUM_ALGORITHMS];
+    pthread_mutex_t lock;
+} campaign_struct;
+
+/*
+    Preconditions:
+        Input: {pointer to the campaign, realization number}
+
+    Purpose of the function: Generates the execution times of one realization on a copy of the taskset and schedules it with every algorithm on the campaign allocation
+                             (run_all_algorithms). The energy is computed as in export_csv.c (find_energy) and the discarded job ratio is the discarded job time executed
+                             over the time available (0 if none was available).
+
+    Postconditions:
+        Output: {void}
+        Result: The results of the realization are stored in the campaign arrays.
+*/
+void run_realization(campaign_struct *campaign, int realization)
+{
+    task_set_struct *task_set = copy_task_set(campaign->task_set);
+    rng_struct rng = rng_split(&(campaign->rng), realization);
+    simulation_result_struct results[NUM_ALGORITHMS];
+    int num_algo, i;
+
+    generate_execution_times(task_set, &rng);
+    run_all_algorithms(task_set, campaign->allocation, results);
+
+    for (num_algo = 0; num_algo < NUM_ALGORITHMS; num_algo++)
+    {
+        campaign->completed[num_algo][realization] = results[num_algo].completed;
+        campaign->energy[num_algo][realization] = find_energy(results[num_algo].active_time, results[num_algo].idle_time);
+        campaign->shutdown_time[num_algo][realization] = results[num_algo].shutdown_time;
+        campaign->discarded_ratio[num_algo][realization] = (results[num_algo].discarded_avail > 0.00) ? results[num_algo].discarded_exec / results[num_algo].discarded_avail : 0.00;
+    }
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        free(task_set->task_list[i].exec_times);
+    }
+    free_task_set_copy(task_set);
+}
+
+/*
+    Function run by each thread of the campaign. The logs of the thread are discarded.
+*/
+void *campaign_worker(void *arg)
+{
+    campaign_struct *campaign = (campaign_struct *)arg;
+    int realization;
+    FILE *null_file = discard_thread_output();
+
+    while (1)
+    {
+        pthread_mutex_lock(&(campaign->lock));
+        realization = campaign->next_realization++;
+        pthread_mutex_unlock(&(campaign->lock));
+
+        if (realization >= campaign->num_realizations)
+            break;
+
+        run_realization(campaign, realization);
+    }
+
+    fclose(null_file);
+    return NULL;
+}
+
+/*
+    Preconditions:
+        Input: {file pointer to the CSV file, name of the algorithm and of the metric, values of the realizations, values to subtract (or NULL),
+                completed flags of the realizations (both must be set if base_completed is not NULL), number of realizations}
+
+    Purpose of the function: Writes the number of completed realizations, the mean, the sample standard deviation and the 95% confidence interval of the mean
+                             (Student t) of the metric over the completed realizations. With base values, the statistics are those of the paired differences.
+
+    Postconditions:
+        Output: {void}
+*/
+void write_campaign_metric(FILE *csv_file, const char *algorithm, const char *metric, double *values, double *base_values, int *completed, int *base_completed, int num_realizations)
+{
+    double sum = 0.00, sum_sq = 0.00, mean = 0.00, stddev = 0.00, half_width = 0.00, value;
+    int i, n = 0;
+
+    for (i = 0; i < num_realizations; i++)
+    {
+        if (!completed[i] || (base_completed != NULL && !base_completed[i]))
+            continue;
+
+        value = values[i] - ((base_values != NULL) ? base_values[i] : 0.00);
+        sum += value;
+        n++;
+    }
+    if (n > 0)
+        mean = sum / n;
+
+    for (i = 0; i < num_realizations; i++)
+    {
+        if (!completed[i] || (base_completed != NULL && !base_completed[i]))
+            continue;
+
+        value = values[i] - ((base_values != NULL) ? base_values[i] : 0.00);
+        sum_sq += (value - mean) * (value - mean);
+    }
+    if (n > 1)
+    {
+        stddev = sqrt(sum_sq / (n - 1));
+        half_width = ((n - 1 <= 30) ? t_quantiles[n - 2] : 1.96) * stddev / sqrt(n);
+    }
+
+    fprintf(csv_file, "%s,%s,%d,%.6lf,%.6lf,%.6lf,%.6lf\n", algorithm, metric, n, mean, stddev, mean - half_width, mean + half_width);
+    printf("%-10s %-24s n=%-5d mean=%.4lf stddev=%.4lf 95%% CI=[%.4lf, %.4lf]\n", algorithm, metric, n, mean, stddev, mean - half_width, mean + half_width);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the taskset (without execution times), pointer to the allocation, number of realizations, seed, file pointer to the CSV file}
+                allocation->feasible == 1, num_realizations > 0
+
+    Purpose of the function: Runs the Monte Carlo campaign: num_realizations sets of execution times are generated from independent streams of the seeded generator
+                             and each one is scheduled with every algorithm on the same allocation, in parallel threads. For each algorithm, the statistics of the energy,
+                             the shutdown time and the discarded job ratio are written in the CSV file, followed by the paired difference of the energy with DPS
+                             (the realizations are common to all the algorithms, so the paired interval is much narrower than the difference of the intervals).
+
+    Postconditions:
+        Output: {void}
+*/
+void run_campaign(task_set_struct *task_set, allocation_struct *allocation, int num_realizations, unsigned long long seed, FILE *csv_file)
+{
+    campaign_struct campaign;
+    pthread_t *threads;
+    int i, num_algo, num_threads = max_int(1, sysconf(_SC_NPROCESSORS_ONLN));
+
+    campaign.task_set = task_set;
+    campaign.allocation = allocation;
+    campaign.rng = rng_init(seed);
+    campaign.num_realizations = num_realizations;
+    campaign.next_realization = 0;
+    for (num_algo = 0; num_algo < NUM_ALGORITHMS; num_algo++)
+    {
+        campaign.completed[num_algo] = calloc(num_realizations, sizeof(int));
+        campaign.energy[num_algo] = calloc(num_realizations, sizeof(double));
+        campaign.shutdown_time[num_algo] = calloc(num_realizations, sizeof(double));
+        campaign.discarded_ratio[num_algo] = calloc(num_realizations, sizeof(double));
+    }
+    pthread_mutex_init(&(campaign.lock), NULL);
+
+    threads = malloc(sizeof(pthread_t) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, campaign_worker, &campaign);
+    }
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&(campaign.lock));
+
+    fprintf(csv_file, "algorithm,metric,realizations,mean,stddev,ci95_low,ci95_high\n");
+    for (num_algo = 0; num_algo < NUM_ALGORITHMS; num_algo++)
+    {
+        const char *name = find_algorithm_name(num_algo);
+        write_campaign_metric(csv_file, name, "energy", campaign.energy[num_algo], NULL, campaign.completed[num_algo], NULL, num_realizations);
+        write_campaign_metric(csv_file, name, "shutdown_time", campaign.shutdown_time[num_algo], NULL, campaign.completed[num_algo], NULL, num_realizations);
+        write_campaign_metric(csv_file, name, "discarded_job_ratio", campaign.discarded_ratio[num_algo], NULL, campaign.completed[num_algo], NULL, num_realizations);
+        if (num_algo > 0)
+            write_campaign_metric(csv_file, name, "energy_difference_to_DPS", campaign.energy[num_algo], campaign.energy[0], campaign.completed[num_algo], campaign.completed[0], num_realizations);
+    }
+
+    for (num_algo = 0; num_algo < NUM_ALGORITHMS; num_algo++)
+    {
+        free(campaign.completed[num_algo]);
+        free(campaign.energy[num_algo]);
+        free(campaign.shutdown_time[num_algo]);
+        free(campaign.discarded_ratio[num_algo]);
+    }
+}
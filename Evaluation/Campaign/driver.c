@@ -0,0 +1,96 @@
+#include "../common/functions.h"
+
+/*
+    Monte Carlo campaign over the execution times of the taskset in ../input_mcs.txt. Usage: ./test [realizations [seed [models]]]
+    The taskset is allocated once with the default DPS allocation. The execution time model of each task can be given in a models file (see load_exec_models);
+    the execution times of these tasks are drawn during the simulation. The results are written in campaign.csv.
+*/
+int main(int argc, char *argv[])
+{
+    int num_realizations = 100;
+    unsigned long long seed = 1;
+    task_set_struct *task_set, *alloc_task_set;
+    processor_struct *processor;
+    allocation_struct allocation;
+    heuristic_struct heuristic = {FIRST_FIT, ORDER_SHUTDOWN, 0.85};
+    FILE *input, *csv_file;
+    MAX_CRITICALITY_LEVELS = 4;
+    //No scheduling options are taken: parse_options sets the defaults.
+    parse_options(0, NULL);
+
+    if (argc > 1)
+        num_realizations = atoi(argv[1]);
+    if (argc > 2)
+        seed = strtoull(argv[2], NULL, 10);
+    if (num_realizations <= 0)
+    {
+        printf("Usage: ./test [realizations [seed [models]]]\n");
+        return 0;
+    }
+
+    input = fopen("../input_mcs.txt", "r");
+    if (input == NULL)
+    {
+        printf("ERROR: Cannot open input file ../input_mcs.txt\n");
+        return 0;
+    }
+    task_set = read_taskset_text(input);
+    fclose(input);
+    if (task_set == NULL)
+    {
+        printf("ERROR: Invalid input file ../input_mcs.txt\n");
+        return 0;
+    }
+
+    if (argc > 3)
+    {
+        input = fopen(argv[3], "r");
+        if (input == NULL || !load_exec_models(input, task_set))
+        {
+            printf("ERROR: Cannot read the execution time models from %s\n", argv[3]);
+            return 0;
+        }
+        fclose(input);
+    }
+
+    //Set the frequency values.
+    frequency[0] = 0.5;
+    frequency[1] = 0.6;
+    frequency[2] = 0.75;
+    frequency[3] = 0.9;
+    frequency[4] = 1.00;
+
+    //The allocation does not depend on the execution times, so it is found once and shared by all the realizations and algorithms.
+    output_file = fopen("/dev/null", "w");
+    find_shutdown_tasks(task_set);
+    alloc_task_set = copy_task_set(task_set);
+    processor = initialize_processor();
+    allocation.feasible = allocate_with_heuristic(alloc_task_set, processor, heuristic);
+    save_allocation(alloc_task_set, processor, &allocation);
+    free_processor(processor);
+    free_task_set_copy(alloc_task_set);
+    fclose(output_file);
+
+    if (!allocation.feasible)
+    {
+        printf("Insufficient cores\n");
+        return 0;
+    }
+
+    csv_file = fopen("campaign.csv", "w");
+    if (csv_file == NULL)
+    {
+        printf("ERROR: Cannot open campaign.csv. Make sure right permissions are provided\n");
+        return 0;
+    }
+
+    printf("Starting campaign of %d realizations\n", num_realizations);
+    run_campaign(task_set, &allocation, num_realizations, seed, csv_file);
+    fclose(csv_file);
+
+    free_allocation(&allocation);
+    free_exec_models(task_set);
+    free_generated_taskset(task_set, 0);
+    printf("Results written in campaign.csv\n");
+    return 0;
+}
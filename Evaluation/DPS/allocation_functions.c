@@ -6,13 +6,12 @@ processor_struct *initialize_processor()
     int i;
 
     processor->total_cores = NUM_CORES;
+    processor->crit_level = 0;
     processor->cores = malloc(sizeof(core_struct) * (processor->total_cores));
 
     for (i = 0; i < processor->total_cores; i++)
     {
-        processor->cores[i].ready_queue = (job_queue_struct *)malloc(sizeof(job_queue_struct));
-        processor->cores[i].ready_queue->num_jobs = 0;
-        processor->cores[i].ready_queue->job_list_head = NULL;
+        processor->cores[i].ready_queue = initialize_job_queue();
         processor->cores[i].curr_exec_job = NULL;
         processor->cores[i].total_time = 0.0f;
         processor->cores[i].total_idle_time = 0.0f;
@@ -22,17 +21,35 @@ processor_struct *initialize_processor()
         processor->cores[i].frequency = 1.00;
         processor->cores[i].x_factor = 0.00;
         processor->cores[i].threshold_crit_lvl = -1;
+        processor->cores[i].crit_level = 0;
+        processor->cores[i].mode_switch_time = 0.00;
 
         processor->cores[i].rem_util = (double *)malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
         for (int j = 0; j < MAX_CRITICALITY_LEVELS; j++)
         {
             processor->cores[i].rem_util[j] = 1.00;
         }
+        processor->cores[i].total_utilisation = (double *)calloc(MAX_CRITICALITY_LEVELS * MAX_CRITICALITY_LEVELS, sizeof(double));
     }
 
     return processor;
 }
 
+void free_processor(processor_struct *processor)
+{
+    int i;
+
+    for (i = 0; i < processor->total_cores; i++)
+    {
+        //The currently executing job is the head of the ready queue, so it is freed with the queue.
+        free_job_queue(processor->cores[i].ready_queue);
+        free(processor->cores[i].rem_util);
+        free(processor->cores[i].total_utilisation);
+    }
+    free(processor->cores);
+    free(processor);
+}
+
 int allocate(task_set_struct *task_set, int task_number, processor_struct *processor, double total_util[][MAX_CRITICALITY_LEVELS], double MAX_UTIL[], int exceptional_task, int shutdown, int non_shutdown_cores, FILE* allocation_file)
 {
     int crit_level = task_set->task_list[task_number].criticality_lvl;
@@ -59,10 +76,14 @@ L1:;
         if (exceptional_task == EXCEPTIONAL || (total_util[num_core][crit_level] + task_set->task_list[task_number].util[crit_level]) <= MAX_UTIL[crit_level])
         {
             task_set->task_list[task_number].core = num_core;
-            x_factor_struct x_factor = check_schedulability(task_set, num_core);
+            add_task_to_index(task_set, task_number, num_core);
+            add_task_utilisation(&(processor->cores[num_core]), &(task_set->task_list[task_number]));
+            x_factor_struct x_factor = check_demand_schedulability(task_set, &(processor->cores[num_core]), num_core);
             if (x_factor.x == 0.00)
             {
                 fprintf(output_file, "Schedulability conditions not satisified.\n");
+                remove_task_utilisation(&(processor->cores[num_core]), &(task_set->task_list[task_number]));
+                remove_task_from_index(task_set, task_number, num_core);
                 task_set->task_list[task_number].core = -1;
             }
             else
@@ -86,6 +107,7 @@ L1:;
                     processor->cores[num_core].rem_util[k] -= task_set->task_list[task_number].util[k];
                 processor->cores[num_core].x_factor = x_factor.x;
                 processor->cores[num_core].threshold_crit_lvl = x_factor.k;
+                set_deadline_factors(task_set, num_core, x_factor);
                 fprintf(output_file, "Allocating task %d to core %d.\n", task_number, num_core);
                 fprintf(allocation_file, "%d %d\n", task_set->task_list[task_number].task_number, num_core);
             }
@@ -117,6 +139,73 @@ L1:;
     }
 }
 
+/*
+    Function to find the non-shutdown tasks and the shutdown tasks. A task is a shutdown task if 2*P - 2*E (the largest idle interval the task allows) is greater than SHUTDOWN_THRESHOLD.
+*/
+void find_shutdown_tasks(task_set_struct *task_set)
+{
+    int i;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        double interval = 2 * task_set->task_list[i].period - 2 * task_set->task_list[i].WCET[task_set->task_list[i].criticality_lvl];
+        if (interval > SHUTDOWN_THRESHOLD)
+        {
+            task_set->task_list[i].shutdown = SHUTDOWN_TASK;
+        }
+        else
+        {
+            task_set->task_list[i].shutdown = NON_SHUTDOWN_TASK;
+        }
+    }
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, cores file}
+                All the tasks are allocated.
+
+    Purpose of the function: Sets the state of each core (cores without tasks are shutdown), sets the virtual deadlines of the tasks of the active cores,
+                             writes the x-factor and threshold level of the active cores in the cores file and builds the task table of each core.
+                             The virtual deadline factor of each task (0 if it uses the x-factor of its core) is written in ../input_deadlines.txt.
+
+    Postconditions:
+        Output: {void}
+*/
+void finalize_allocation(task_set_struct *task_set, processor_struct *processor, FILE *cores_file)
+{
+    int i;
+    FILE *deadlines_file = fopen("../input_deadlines.txt", "w");
+
+    for (i = 0; i < processor->total_cores; i++)
+    {
+        if (processor->cores[i].x_factor == 0)
+        {
+            processor->cores[i].state = SHUTDOWN;
+        }
+        else
+        {
+            processor->cores[i].state = ACTIVE;
+            fprintf(output_file, "Core: %d, x factor: %.5lf, K value: %d\n", i, processor->cores[i].x_factor, processor->cores[i].threshold_crit_lvl);
+            set_virtual_deadlines(&task_set, i, processor->cores[i].x_factor, processor->cores[i].threshold_crit_lvl);
+            fprintf(cores_file, "%lf %d\n", processor->cores[i].x_factor, processor->cores[i].threshold_crit_lvl);
+        }
+    }
+    fprintf(output_file, "\n");
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        fprintf(deadlines_file, "%d %lf\n", task_set->task_list[i].task_number, task_set->task_list[i].deadline_factor);
+    }
+    fclose(deadlines_file);
+
+    //The virtual deadlines are set. Build the task table of each core used by the scheduler.
+    build_task_table(task_set);
+
+    return;
+}
+
 int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *processor)
 {
     int i;
@@ -128,6 +217,9 @@ int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *process
     allocation_file = fopen("../input_allocation.txt", "w");
     cores_file = fopen("../input_cores.txt", "w");
 
+    //The task index of each core is filled as the tasks are allocated.
+    initialize_task_index(task_set);
+
     //Maximum utilisation per criticality level allowed for each core.
     MAX_UTIL[0] = 0.85, MAX_UTIL[1] = 0.85, MAX_UTIL[2] = 0.85, MAX_UTIL[3] = 0.85;
 
@@ -140,17 +232,36 @@ int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *process
     }
 
     //Find the non-shutdown tasks and the shutdown tasks based on the value of 2*P - 2*E.
-    for (i = 0; i < total_tasks; i++)
+    find_shutdown_tasks(task_set);
+
+    if (allocation_mode != DEFAULT_ALLOCATION)
     {
-        double interval = 2 * task_set->task_list[i].period - 2 * task_set->task_list[i].WCET[task_set->task_list[i].criticality_lvl];
-        if (interval > SHUTDOWN_THRESHOLD)
+        int result;
+        if (allocation_mode == PORTFOLIO_ALLOCATION || allocation_mode == PROBABILISTIC_ALLOCATION)
+            result = allocate_tasks_portfolio(task_set, processor, allocation_file);
+        else if (allocation_mode == OPTIMIZED_ALLOCATION)
+            result = allocate_tasks_optimized(task_set, processor, allocation_file);
+        else
+            result = allocate_tasks_minimum_cores(task_set, processor, allocation_file);
+
+        if (result == 0)
         {
-            task_set->task_list[i].shutdown = SHUTDOWN_TASK;
+            fprintf(output_file, "Insufficient number of cores\n");
+            return 0;
         }
-        else
+        if (allocation_mode == PROBABILISTIC_ALLOCATION)
         {
-            task_set->task_list[i].shutdown = NON_SHUTDOWN_TASK;
+            double horizon = find_superhyperperiod(task_set);
+            for (i = 0; i < processor->total_cores; i++)
+            {
+                probability_struct probability = analyse_core_probability(task_set, i, horizon);
+                fprintf(output_file, "Core %d: Deadline miss probability: %.6lf, Mode switch probability: %.6lf\n", i, probability.deadline_miss, probability.mode_switch);
+            }
         }
+        finalize_allocation(task_set, processor, cores_file);
+        fclose(allocation_file);
+        fclose(cores_file);
+        return 1;
     }
 
     //Calculate the total utilisation of non-shutdown tasks.
@@ -228,21 +339,8 @@ int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *process
         }
     }
 
-    for (i = 0; i < processor->total_cores; i++)
-    {
-        if (processor->cores[i].x_factor == 0)
-        {
-            processor->cores[i].state = SHUTDOWN;
-        }
-        else
-        {
-            processor->cores[i].state = ACTIVE;
-            fprintf(output_file, "Core: %d, x factor: %.5lf, K value: %d\n", i, processor->cores[i].x_factor, processor->cores[i].threshold_crit_lvl);
-            set_virtual_deadlines(&task_set, i, processor->cores[i].x_factor, processor->cores[i].threshold_crit_lvl);
-            fprintf(cores_file, "%lf %d\n", processor->cores[i].x_factor, processor->cores[i].threshold_crit_lvl);
-        }
-    }
-    fprintf(output_file, "\n");
+    finalize_allocation(task_set, processor, cores_file);
+
     fclose(allocation_file);
     fclose(cores_file);
     return 1;
@@ -0,0 +1,446 @@
+#include "../common/functions.h"
+#include <pthread.h>
+
+//Parameters of the simulated annealing.
+#define OPTIMIZER_ITERATIONS 40
+#define OPTIMIZER_COOLING 0.90
+#define OPTIMIZER_INITIAL_TEMPERATURE 0.02
+#define OPTIMIZER_SEED 1
+
+//The candidate allocations are simulated for this number of periods of the task with the largest period.
+#define OPTIMIZER_HORIZON_PERIODS 20
+
+/*
+    Data shared by the threads which evaluate a batch of candidate allocations. Each thread picks the next candidate from next_candidate.
+*/
+typedef struct optimizer_struct
+{
+    task_set_struct *task_set;
+    allocation_struct *candidates;
+    int num_candidates;
+    int next_candidate;
+    pthread_mutex_t lock;
+} optimizer_struct;
+
+/*
+    Function to create an allocation with the given core of each task. The per core values are filled by check_allocation_schedulability.
+*/
+void initialize_allocation(allocation_struct *allocation, int total_tasks, int total_cores)
+{
+    allocation->core = malloc(sizeof(int) * total_tasks);
+    allocation->deadline_factor = calloc(total_tasks, sizeof(double));
+    allocation->x_factor = calloc(total_cores, sizeof(double));
+    allocation->threshold_crit_lvl = malloc(sizeof(int) * total_cores);
+    allocation->is_shutdown = malloc(sizeof(int) * total_cores);
+    allocation->feasible = 0;
+    allocation->energy = 0.00;
+    allocation->shutdown = 0.00;
+}
+
+void copy_allocation(allocation_struct *dest, allocation_struct *src, int total_tasks, int total_cores)
+{
+    memcpy(dest->core, src->core, sizeof(int) * total_tasks);
+    memcpy(dest->deadline_factor, src->deadline_factor, sizeof(double) * total_tasks);
+    memcpy(dest->x_factor, src->x_factor, sizeof(double) * total_cores);
+    memcpy(dest->threshold_crit_lvl, src->threshold_crit_lvl, sizeof(int) * total_cores);
+    memcpy(dest->is_shutdown, src->is_shutdown, sizeof(int) * total_cores);
+    dest->feasible = src->feasible;
+    dest->energy = src->energy;
+    dest->shutdown = src->shutdown;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to the allocation}
+                allocation->core is set for all the tasks. allocation->deadline_factor holds the factors of the allocation it was derived from (or 0).
+
+    Purpose of the function: Checks each core with the demand-based EDF-VD test used by allocate and the portfolio (check_demand_schedulability) for the tasks
+                             allocated to it by the allocation. The task index and the utilisation matrix of each core are built on a private copy of the taskset
+                             and a private processor, so the candidates can be checked in parallel threads.
+                             The per-task virtual deadline factors are re-tuned with set_deadline_factors, starting from the factors stored in the allocation.
+
+    Postconditions:
+        Output: {1 if all the cores are schedulable, else 0}
+        Result: The x-factor, threshold level and shutdown type of each core and the virtual deadline factor of each task are set in the allocation.
+*/
+int check_allocation_schedulability(task_set_struct *task_set, allocation_struct *allocation)
+{
+    task_set_struct *check_task_set = copy_task_set(task_set);
+    processor_struct *processor = initialize_processor();
+    int num_core, i, schedulable = 1;
+    x_factor_struct x_factor;
+    task *curr_task;
+    core_struct *core;
+
+    for (i = 0; i < check_task_set->total_tasks; i++)
+    {
+        curr_task = &(check_task_set->task_list[i]);
+        curr_task->core = allocation->core[i];
+        curr_task->deadline_factor = allocation->deadline_factor[i];
+
+        core = &(processor->cores[curr_task->core]);
+        add_task_to_index(check_task_set, i, curr_task->core);
+        add_task_utilisation(core, curr_task);
+        if (core->is_shutdown != NON_SHUTDOWN_CORE)
+            core->is_shutdown = (curr_task->shutdown == SHUTDOWN_TASK) ? SHUTDOWN_CORE : NON_SHUTDOWN_CORE;
+    }
+
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        core = &(processor->cores[num_core]);
+        allocation->is_shutdown[num_core] = core->is_shutdown;
+        allocation->x_factor[num_core] = 0.00;
+        allocation->threshold_crit_lvl[num_core] = -1;
+        if (core->is_shutdown == -1)
+            continue;
+
+        x_factor = check_demand_schedulability(check_task_set, core, num_core);
+        if (x_factor.x == 0.00)
+        {
+            schedulable = 0;
+            break;
+        }
+
+        set_deadline_factors(check_task_set, num_core, x_factor);
+        allocation->x_factor[num_core] = x_factor.x;
+        allocation->threshold_crit_lvl[num_core] = x_factor.k;
+    }
+
+    for (i = 0; i < check_task_set->total_tasks; i++)
+    {
+        allocation->deadline_factor[i] = check_task_set->task_list[i].deadline_factor;
+    }
+
+    free_processor(processor);
+    free_task_set_copy(check_task_set);
+    return schedulable;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to the allocation, algorithm}
+                The allocation is schedulable and the statistics of the thread are initialized.
+
+    Purpose of the function: Schedules the taskset with the algorithm for the allocation on a private copy of the taskset and a private processor,
+                             up to the super hyperperiod (or simulation_horizon, if it is set).
+                             The copy shares the WCET, utilisation and execution times with the given taskset, so no input is read again.
+
+    Postconditions:
+        Output: {1 if all the cores reached the end of the simulation, 0 if a deadline was missed}
+        Result: The statistics of the run are added to the statistics of the thread.
+*/
+int run_simulation(task_set_struct *task_set, allocation_struct *allocation, int algo)
+{
+    task_set_struct *sim_task_set = copy_task_set(task_set);
+    processor_struct *processor = initialize_processor();
+    double horizon = find_superhyperperiod(task_set);
+    int i, num_core, completed = 1;
+
+    if (simulation_horizon > 0.00)
+        horizon = min(horizon, simulation_horizon);
+
+    for (i = 0; i < sim_task_set->total_tasks; i++)
+    {
+        sim_task_set->task_list[i].core = allocation->core[i];
+        sim_task_set->task_list[i].deadline_factor = allocation->deadline_factor[i];
+        add_task_to_index(sim_task_set, i, allocation->core[i]);
+    }
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        processor->cores[num_core].x_factor = allocation->x_factor[num_core];
+        processor->cores[num_core].threshold_crit_lvl = allocation->threshold_crit_lvl[num_core];
+        processor->cores[num_core].is_shutdown = allocation->is_shutdown[num_core];
+        if (allocation->x_factor[num_core] == 0)
+        {
+            processor->cores[num_core].state = SHUTDOWN;
+        }
+        else
+        {
+            processor->cores[num_core].state = ACTIVE;
+            set_virtual_deadlines(&sim_task_set, num_core, allocation->x_factor[num_core], allocation->threshold_crit_lvl[num_core]);
+        }
+    }
+    build_task_table(sim_task_set);
+
+    schedule_taskset(sim_task_set, processor, algo);
+
+    //The scheduler stops at the first deadline miss, before all the cores reach the horizon.
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        if (processor->cores[num_core].total_time < horizon)
+            completed = 0;
+    }
+
+    free_processor(processor);
+    free_task_set_copy(sim_task_set);
+    return completed;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to the allocation}
+                The allocation is schedulable and simulation_horizon is set.
+
+    Purpose of the function: Simulates DPS for the allocation with run_simulation, using fresh statistics.
+
+    Postconditions:
+        Output: {void}
+        Result: allocation->energy is the total active and idle time of all the cores and allocation->shutdown is their total shutdown time.
+                If a deadline is missed, the allocation is marked as not feasible.
+*/
+void simulate_allocation(task_set_struct *task_set, allocation_struct *allocation)
+{
+    int num_core;
+
+    initialize_stats_struct();
+    if (run_simulation(task_set, allocation, DPS) == 0)
+        allocation->feasible = 0;
+
+    allocation->energy = 0.00;
+    allocation->shutdown = 0.00;
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        allocation->energy += stats->total_active_energy[num_core] + stats->total_idle_energy[num_core];
+        allocation->shutdown += stats->total_shutdown_time[num_core];
+    }
+
+    free_stats_struct(stats);
+    stats = NULL;
+    return;
+}
+
+/*
+    Function run by each thread of the optimizer. The thread takes the next candidate, checks its schedulability and simulates it.
+    The logs of the thread are discarded.
+*/
+void *optimizer_worker(void *arg)
+{
+    optimizer_struct *optimizer = (optimizer_struct *)arg;
+    int num_candidate, num_core;
+    FILE *null_file = fopen("/dev/null", "w");
+
+    output_file = null_file;
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        output[num_core] = null_file;
+    }
+
+    while (1)
+    {
+        pthread_mutex_lock(&(optimizer->lock));
+        num_candidate = optimizer->next_candidate++;
+        pthread_mutex_unlock(&(optimizer->lock));
+
+        if (num_candidate >= optimizer->num_candidates)
+            break;
+
+        allocation_struct *candidate = &(optimizer->candidates[num_candidate]);
+        candidate->feasible = check_allocation_schedulability(optimizer->task_set, candidate);
+        if (candidate->feasible)
+            simulate_allocation(optimizer->task_set, candidate);
+    }
+
+    fclose(null_file);
+    return NULL;
+}
+
+/*
+    Function to evaluate a batch of candidate allocations in parallel threads.
+*/
+void evaluate_candidates(task_set_struct *task_set, allocation_struct *candidates, int num_candidates, int num_threads)
+{
+    optimizer_struct optimizer;
+    pthread_t *threads = malloc(sizeof(pthread_t) * num_threads);
+    int i;
+
+    optimizer.task_set = task_set;
+    optimizer.candidates = candidates;
+    optimizer.num_candidates = num_candidates;
+    optimizer.next_candidate = 0;
+    pthread_mutex_init(&(optimizer.lock), NULL);
+
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, optimizer_worker, &optimizer);
+    }
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&(optimizer.lock));
+    free(threads);
+}
+
+/*
+    Function to create a neighbour of the allocation: either a random task is moved to another core, or two random tasks on different cores are swapped.
+    The second task of a swap is drawn from the tasks on the other cores, so a swap never leaves the allocation unchanged. If all the tasks are on one core, the task is moved.
+*/
+void find_neighbour_allocation(allocation_struct *neighbour, allocation_struct *current, int total_tasks, int total_cores, unsigned int *seed)
+{
+    int task_a, task_b, num_core, num_other = 0;
+
+    copy_allocation(neighbour, current, total_tasks, total_cores);
+
+    task_a = rand_r(seed) % total_tasks;
+    if (rand_r(seed) % 2 == 0)
+    {
+        for (task_b = 0; task_b < total_tasks; task_b++)
+        {
+            if (current->core[task_b] != current->core[task_a])
+                num_other++;
+        }
+    }
+
+    if (num_other == 0)
+    {
+        num_core = rand_r(seed) % (total_cores - 1);
+        if (num_core >= current->core[task_a])
+            num_core++;
+        neighbour->core[task_a] = num_core;
+    }
+    else
+    {
+        //The second task is the num_other-th task (from 0) on another core.
+        num_other = rand_r(seed) % num_other;
+        for (task_b = 0; task_b < total_tasks; task_b++)
+        {
+            if (current->core[task_b] != current->core[task_a] && num_other-- == 0)
+                break;
+        }
+        neighbour->core[task_a] = current->core[task_b];
+        neighbour->core[task_b] = current->core[task_a];
+    }
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to the result allocation}
+                The shutdown and non-shutdown tasks are found.
+
+    Purpose of the function: Searches for the allocation with the lowest simulated energy (total active and idle time) with simulated annealing.
+                             The search starts from the allocation of the portfolio. In each iteration, a batch of neighbours is evaluated in parallel and the best
+                             schedulable one is accepted if it has lower energy, or with probability exp(-delta / temperature) otherwise.
+                             The candidates are simulated up to OPTIMIZER_HORIZON_PERIODS times the largest period (or the super hyperperiod, if smaller).
+
+    Postconditions:
+        Output: {1 if a feasible allocation was found, else 0}
+        Result: The best allocation found is stored in result (to be freed with free_allocation).
+*/
+int find_optimized_allocation(task_set_struct *task_set, allocation_struct *result)
+{
+    allocation_struct seed_allocation, current, best;
+    allocation_struct *candidates;
+    int total_tasks = task_set->total_tasks;
+    int num_threads = max_int(1, sysconf(_SC_NPROCESSORS_ONLN));
+    int num_candidates = max_int(4, 2 * num_threads);
+    int iteration, i, chosen;
+    unsigned int seed = OPTIMIZER_SEED;
+    double max_period = 0.00, temperature;
+
+    if (find_portfolio_allocation(task_set, NUM_CORES, &seed_allocation) == 0)
+        return 0;
+
+    for (i = 0; i < total_tasks; i++)
+    {
+        max_period = max(max_period, task_set->task_list[i].period);
+    }
+    simulation_horizon = OPTIMIZER_HORIZON_PERIODS * max_period;
+
+    initialize_allocation(&current, total_tasks, NUM_CORES);
+    initialize_allocation(&best, total_tasks, NUM_CORES);
+    candidates = malloc(sizeof(allocation_struct) * num_candidates);
+    for (i = 0; i < num_candidates; i++)
+    {
+        initialize_allocation(&candidates[i], total_tasks, NUM_CORES);
+    }
+
+    //Evaluate the allocation of the portfolio with the same simulation as the candidates.
+    copy_allocation(&candidates[0], &seed_allocation, total_tasks, NUM_CORES);
+    evaluate_candidates(task_set, candidates, 1, 1);
+    copy_allocation(&current, &candidates[0], total_tasks, NUM_CORES);
+    if (current.feasible == 0)
+    {
+        //The portfolio allocation misses a deadline in the simulation. Keep it as the fallback, but let any feasible neighbour replace it.
+        current.energy = INT_MAX;
+    }
+    copy_allocation(&best, &current, total_tasks, NUM_CORES);
+
+    fprintf(output_file, "Allocation optimizer: horizon %.2lf, %d candidates per iteration\n", simulation_horizon, num_candidates);
+    fprintf(output_file, "Initial allocation | Energy: %.2lf, Shutdown: %.2lf\n", current.energy, current.shutdown);
+
+    temperature = OPTIMIZER_INITIAL_TEMPERATURE * (current.feasible ? current.energy : simulation_horizon * NUM_CORES);
+    for (iteration = 0; iteration < OPTIMIZER_ITERATIONS && NUM_CORES > 1; iteration++)
+    {
+        for (i = 0; i < num_candidates; i++)
+        {
+            find_neighbour_allocation(&candidates[i], &current, total_tasks, NUM_CORES, &seed);
+        }
+        evaluate_candidates(task_set, candidates, num_candidates, min_int(num_threads, num_candidates));
+
+        chosen = -1;
+        for (i = 0; i < num_candidates; i++)
+        {
+            if (candidates[i].feasible && (chosen == -1 || candidates[i].energy < candidates[chosen].energy))
+                chosen = i;
+        }
+
+        if (chosen != -1)
+        {
+            double delta = candidates[chosen].energy - current.energy;
+            if (delta < 0 || (double)rand_r(&seed) / RAND_MAX < exp(-delta / temperature))
+            {
+                copy_allocation(&current, &candidates[chosen], total_tasks, NUM_CORES);
+            }
+            if (current.energy < best.energy)
+            {
+                copy_allocation(&best, &current, total_tasks, NUM_CORES);
+            }
+        }
+
+        fprintf(output_file, "Iteration %d | Temperature: %.2lf, Current energy: %.2lf, Best energy: %.2lf\n", iteration, temperature, current.energy, best.energy);
+        temperature *= OPTIMIZER_COOLING;
+    }
+
+    //The result must be schedulable. If no allocation passed the test and the simulation, keep the portfolio allocation with its own x-factors and deadline factors.
+    if (best.feasible == 0 || check_allocation_schedulability(task_set, &best) == 0)
+    {
+        fprintf(output_file, "Allocation optimizer: no schedulable allocation found, keeping the portfolio allocation\n");
+        copy_allocation(&best, &seed_allocation, total_tasks, NUM_CORES);
+    }
+    free_allocation(&seed_allocation);
+    fprintf(output_file, "Selected allocation | Energy: %.2lf, Shutdown: %.2lf\n\n", best.energy, best.shutdown);
+    *result = best;
+
+    for (i = 0; i < num_candidates; i++)
+    {
+        free_allocation(&candidates[i]);
+    }
+    free(candidates);
+    free_allocation(&current);
+    simulation_horizon = 0.00;
+
+    return 1;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, allocation file}
+                The shutdown and non-shutdown tasks are found.
+
+    Purpose of the function: Selects an allocation with find_optimized_allocation, applies it to the taskset and writes it in the allocation file.
+
+    Postconditions:
+        Output: {1 if a feasible allocation was found, else 0}
+*/
+int allocate_tasks_optimized(task_set_struct *task_set, processor_struct *processor, FILE *allocation_file)
+{
+    allocation_struct allocation;
+
+    if (find_optimized_allocation(task_set, &allocation) == 0)
+        return 0;
+
+    apply_allocation(task_set, processor, &allocation, allocation_file);
+    free_allocation(&allocation);
+    return 1;
+}
@@ -0,0 +1,643 @@
+#include "../common/functions.h"
+#include <pthread.h>
+
+//Power (dynamic + static) of a core while executing and while idle, as used in export_csv.
+#define ACTIVE_POWER 1.50
+#define IDLE_POWER 1.00
+
+/*
+    Data shared by the threads of the portfolio. Each thread picks the next heuristic to run from next_heuristic.
+*/
+typedef struct portfolio_struct
+{
+    task_set_struct *task_set;
+    int num_cores;
+    heuristic_struct *heuristics;
+    allocation_struct *allocations;
+    int num_heuristics;
+    int next_heuristic;
+    pthread_mutex_t lock;
+} portfolio_struct;
+
+/*
+    Function to compare two tasks (given by their indices) for the allocation order of a heuristic.
+    The task set and the order are passed through these variables as qsort does not take a context argument. They are private to each thread.
+*/
+static __thread task_set_struct *order_task_set;
+static __thread int order_type;
+
+static int task_order_comparator(const void *p, const void *q)
+{
+    task *l = &(order_task_set->task_list[*(int *)p]);
+    task *r = &(order_task_set->task_list[*(int *)q]);
+    double util_l = l->util[l->criticality_lvl];
+    double util_r = r->util[r->criticality_lvl];
+
+    if (order_type == ORDER_CRITICALITY && l->criticality_lvl != r->criticality_lvl)
+        return r->criticality_lvl - l->criticality_lvl;
+    if (util_l != util_r)
+        return (util_l < util_r) ? 1 : -1;
+    return *(int *)p - *(int *)q;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, heuristic, array for the allocation order}
+                order has space for all the tasks
+
+    Purpose of the function: Finds the order in which the tasks are allocated by the heuristic.
+                             ORDER_SHUTDOWN is the order used by allocate_tasks_to_cores: exceptional tasks, then non-shutdown tasks and then shutdown tasks,
+                             each group from the highest criticality level to the lowest.
+
+    Postconditions:
+        Output: {void}
+*/
+void find_allocation_order(task_set_struct *task_set, heuristic_struct heuristic, int *order)
+{
+    int i, crit_level, shutdown, num_order = 0;
+    int total_tasks = task_set->total_tasks;
+    task *task_list = task_set->task_list;
+    int *added = calloc(total_tasks, sizeof(int));
+
+    if (heuristic.order == ORDER_SHUTDOWN)
+    {
+        for (i = 0; i < total_tasks; i++)
+        {
+            if (task_list[i].util[task_list[i].criticality_lvl] > heuristic.max_util)
+            {
+                order[num_order++] = i;
+                added[i] = 1;
+            }
+        }
+        for (shutdown = NON_SHUTDOWN_TASK; shutdown >= SHUTDOWN_TASK; shutdown--)
+        {
+            for (crit_level = MAX_CRITICALITY_LEVELS - 1; crit_level >= 0; crit_level--)
+            {
+                for (i = 0; i < total_tasks; i++)
+                {
+                    if (added[i] == 0 && task_list[i].shutdown == shutdown && task_list[i].criticality_lvl == crit_level)
+                    {
+                        order[num_order++] = i;
+                        added[i] = 1;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        for (i = 0; i < total_tasks; i++)
+        {
+            order[i] = i;
+        }
+        order_task_set = task_set;
+        order_type = heuristic.order;
+        qsort(order, total_tasks, sizeof(int), task_order_comparator);
+    }
+
+    free(added);
+    return;
+}
+
+/*
+    Function to check the utilisation conditions of allocate for a task on a core: the remaining utilisation of the core at each level up to the task's level,
+    and the maximum utilisation per criticality level (skipped for exceptional tasks).
+*/
+int check_core_capacity(core_struct *core, task *new_task, double max_util, int exceptional_task)
+{
+    int k, crit_level = new_task->criticality_lvl;
+
+    for (k = 0; k <= crit_level; k++)
+    {
+        if (core->rem_util[k] < new_task->util[k])
+            return 0;
+    }
+
+    if (exceptional_task != EXCEPTIONAL && core->total_utilisation[crit_level * MAX_CRITICALITY_LEVELS + crit_level] + new_task->util[crit_level] > max_util)
+        return 0;
+
+    return 1;
+}
+
+/*
+    Function to find the load of a core in the lowest criticality mode, i.e., the sum of U[l][l] over all levels.
+*/
+double find_core_load(core_struct *core)
+{
+    double load = 0.00;
+    int l;
+
+    for (l = 0; l < MAX_CRITICALITY_LEVELS; l++)
+    {
+        load += core->total_utilisation[l * MAX_CRITICALITY_LEVELS + l];
+    }
+    return load;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, heuristic}
+                All the tasks are unallocated and the task index is initialized.
+
+    Purpose of the function: Allocates the tasks to the cores using the heuristic. For each task (in the order of the heuristic), the cores on which the task satisfies
+                             the utilisation conditions and the EDF-VD schedulability condition (check_demand_schedulability) are candidates. First fit takes the first candidate, best fit the candidate
+                             with the highest load and worst fit the candidate with the lowest load. Mode switch fit takes the candidate with the lowest probability of
+                             leaving the lowest criticality mode: a job of task i overruns its WCET at the lowest level with probability p_i (find_overrun_probability), so
+                             a core does not switch in a time t with probability exp(-t * sum(-log(1 - p_i) / period_i)) and the candidate with the lowest sum is taken.
+
+    Postconditions:
+        Output: {1 if all the tasks are allocated, else 0}
+        Result: The core of each task, the task index and the x-factor of each core are updated.
+*/
+int allocate_with_heuristic(task_set_struct *task_set, processor_struct *processor, heuristic_struct heuristic)
+{
+    int num_order, num_core, chosen_core, task_number, k;
+    int *order = malloc(sizeof(int) * task_set->total_tasks);
+    double load, chosen_load, switch_rate = 0.00, horizon = find_superhyperperiod(task_set);
+    double *core_switch_rate = calloc(processor->total_cores, sizeof(double));
+    x_factor_struct x_factor, chosen_x_factor;
+    task *curr_task;
+    core_struct *core;
+    pmf_struct *pmf;
+
+    find_allocation_order(task_set, heuristic, order);
+
+    for (num_order = 0; num_order < task_set->total_tasks; num_order++)
+    {
+        task_number = order[num_order];
+        curr_task = &(task_set->task_list[task_number]);
+        int exceptional_task = (curr_task->util[curr_task->criticality_lvl] > heuristic.max_util) ? EXCEPTIONAL : 0;
+
+        chosen_core = -1;
+        chosen_load = 0.00;
+        chosen_x_factor.x = 0.00;
+        chosen_x_factor.k = -1;
+
+        if (heuristic.fit == MODE_SWITCH_FIT && curr_task->criticality_lvl > 0)
+        {
+            pmf = find_task_pmf(curr_task, horizon);
+            switch_rate = -log1p(-min(find_overrun_probability(pmf, curr_task->WCET[0]), 1.00 - 1e-12)) / curr_task->period;
+            free_pmf(pmf);
+        }
+        else
+            switch_rate = 0.00;
+
+        for (num_core = 0; num_core < processor->total_cores; num_core++)
+        {
+            core = &(processor->cores[num_core]);
+            if (check_core_capacity(core, curr_task, heuristic.max_util, exceptional_task) == 0)
+                continue;
+
+            //Tentatively add the task to the core and check the schedulability.
+            add_task_utilisation(core, curr_task);
+            add_task_to_index(task_set, task_number, num_core);
+            x_factor = check_demand_schedulability(task_set, core, num_core);
+            load = find_core_load(core);
+            remove_task_from_index(task_set, task_number, num_core);
+            remove_task_utilisation(core, curr_task);
+
+            if (x_factor.x == 0.00)
+                continue;
+
+            if (heuristic.fit == MODE_SWITCH_FIT)
+                load = core_switch_rate[num_core] + switch_rate;
+
+            if (chosen_core == -1 || (heuristic.fit == BEST_FIT && load > chosen_load) || ((heuristic.fit == WORST_FIT || heuristic.fit == MODE_SWITCH_FIT) && load < chosen_load))
+            {
+                chosen_core = num_core;
+                chosen_load = load;
+                chosen_x_factor = x_factor;
+            }
+
+            if (heuristic.fit == FIRST_FIT)
+                break;
+        }
+
+        if (chosen_core == -1)
+        {
+            fprintf(output_file, "Task %d could not be allocated\n", task_number);
+            free(order);
+            free(core_switch_rate);
+            return 0;
+        }
+
+        core = &(processor->cores[chosen_core]);
+        core_switch_rate[chosen_core] += switch_rate;
+        curr_task->core = chosen_core;
+        add_task_to_index(task_set, task_number, chosen_core);
+        add_task_utilisation(core, curr_task);
+        for (k = 0; k < curr_task->criticality_lvl; k++)
+            core->rem_util[k] -= curr_task->util[k];
+        core->x_factor = chosen_x_factor.x;
+        core->threshold_crit_lvl = chosen_x_factor.k;
+        set_deadline_factors(task_set, chosen_core, chosen_x_factor);
+        if (core->is_shutdown == -1)
+            core->is_shutdown = (curr_task->shutdown == SHUTDOWN_TASK) ? SHUTDOWN_CORE : NON_SHUTDOWN_CORE;
+        fprintf(output_file, "Allocating task %d to core %d.\n", task_number, chosen_core);
+    }
+
+    free(order);
+    free(core_switch_rate);
+    return 1;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, pointer to the allocation}
+
+    Purpose of the function: Computes a fast analytic estimate of the energy and shutdown time of the allocation.
+                             A core with no tasks is shutdown for the whole time. For a core with tasks, the active fraction is the load of the core in the lowest
+                             criticality mode and the rest of the time is idle. Procrastination gathers the idle time in intervals of about (1 - load) * (Pmin + Pmax),
+                             where Pmin and Pmax are the smallest and largest periods on the core; the fraction 1 - SHUTDOWN_THRESHOLD / interval of the idle time
+                             is counted as shutdown time.
+                             The energy per unit time is ACTIVE_POWER for active time and IDLE_POWER for idle time, same as in export_csv.
+
+    Postconditions:
+        Output: {void}
+        Result: allocation->energy and allocation->shutdown are the energy per unit time and the shutdown fraction, summed over all cores.
+*/
+void estimate_allocation_energy(task_set_struct *task_set, processor_struct *processor, allocation_struct *allocation)
+{
+    int num_core, crit_level, i;
+    double load, idle, shutdown, interval, min_period, max_period;
+    task_index_struct *index;
+    task *curr_task;
+
+    allocation->energy = 0.00;
+    allocation->shutdown = 0.00;
+
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        index = &(task_set->core_index[num_core]);
+        load = 0.00;
+        min_period = INT_MAX;
+        max_period = 0.00;
+
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            for (i = 0; i < index->num_tasks[crit_level]; i++)
+            {
+                curr_task = &(task_set->task_list[index->task_list[crit_level][i]]);
+                load += curr_task->util[0];
+                min_period = min(min_period, curr_task->period);
+                max_period = max(max_period, curr_task->period);
+            }
+        }
+
+        if (max_period == 0.00)
+        {
+            allocation->shutdown += 1.00;
+            continue;
+        }
+
+        load = min(load, 1.00);
+        idle = 1.00 - load;
+        interval = idle * (min_period + max_period);
+        shutdown = (interval > SHUTDOWN_THRESHOLD) ? idle * (1.00 - SHUTDOWN_THRESHOLD / interval) : 0.00;
+
+        allocation->energy += load * ACTIVE_POWER + (idle - shutdown) * IDLE_POWER;
+        allocation->shutdown += shutdown;
+    }
+
+    return;
+}
+
+/*
+    Function to store the result of an allocation (core and virtual deadline factor of each task and x-factor of each core).
+    The values of all NUM_CORES cores are stored, so that an allocation made on fewer cores can be applied to the full processor (the unused cores are empty).
+*/
+void save_allocation(task_set_struct *task_set, processor_struct *processor, allocation_struct *allocation)
+{
+    int i;
+
+    allocation->mode_switch = 0.00;
+    allocation->core = malloc(sizeof(int) * task_set->total_tasks);
+    allocation->deadline_factor = malloc(sizeof(double) * task_set->total_tasks);
+    allocation->x_factor = malloc(sizeof(double) * NUM_CORES);
+    allocation->threshold_crit_lvl = malloc(sizeof(int) * NUM_CORES);
+    allocation->is_shutdown = malloc(sizeof(int) * NUM_CORES);
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        allocation->core[i] = task_set->task_list[i].core;
+        allocation->deadline_factor[i] = task_set->task_list[i].deadline_factor;
+    }
+    for (i = 0; i < NUM_CORES; i++)
+    {
+        allocation->x_factor[i] = processor->cores[i].x_factor;
+        allocation->threshold_crit_lvl[i] = processor->cores[i].threshold_crit_lvl;
+        allocation->is_shutdown[i] = processor->cores[i].is_shutdown;
+    }
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, pointer to the allocation, allocation file}
+                The tasks of the taskset are unallocated.
+
+    Purpose of the function: Applies a saved allocation to the taskset and the processor and writes it in the allocation file (in the same format as allocate).
+
+    Postconditions:
+        Output: {void}
+*/
+void apply_allocation(task_set_struct *task_set, processor_struct *processor, allocation_struct *allocation, FILE *allocation_file)
+{
+    int i, k;
+    task *curr_task;
+    core_struct *core;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        curr_task = &(task_set->task_list[i]);
+        curr_task->core = allocation->core[i];
+        curr_task->deadline_factor = allocation->deadline_factor[i];
+        if (curr_task->core < 0)
+            continue;
+
+        core = &(processor->cores[curr_task->core]);
+        add_task_to_index(task_set, i, curr_task->core);
+        add_task_utilisation(core, curr_task);
+        for (k = 0; k < curr_task->criticality_lvl; k++)
+            core->rem_util[k] -= curr_task->util[k];
+
+        fprintf(output_file, "Allocating task %d to core %d.\n", i, curr_task->core);
+        fprintf(allocation_file, "%d %d\n", curr_task->task_number, curr_task->core);
+    }
+
+    for (i = 0; i < processor->total_cores; i++)
+    {
+        processor->cores[i].x_factor = allocation->x_factor[i];
+        processor->cores[i].threshold_crit_lvl = allocation->threshold_crit_lvl[i];
+        processor->cores[i].is_shutdown = allocation->is_shutdown[i];
+    }
+    return;
+}
+
+void free_allocation(allocation_struct *allocation)
+{
+    free(allocation->core);
+    free(allocation->deadline_factor);
+    free(allocation->x_factor);
+    free(allocation->threshold_crit_lvl);
+    free(allocation->is_shutdown);
+}
+
+/*
+    Function run by each thread of the portfolio. The thread takes the next heuristic, allocates a private copy of the taskset on a private processor and
+    stores the resulting allocation, its estimated energy and (for PROBABILISTIC_ALLOCATION) its mode switch probability. The log of the thread is discarded.
+*/
+void *portfolio_worker(void *arg)
+{
+    portfolio_struct *portfolio = (portfolio_struct *)arg;
+    int num_heuristic;
+
+    output_file = fopen("/dev/null", "w");
+
+    while (1)
+    {
+        pthread_mutex_lock(&(portfolio->lock));
+        num_heuristic = portfolio->next_heuristic++;
+        pthread_mutex_unlock(&(portfolio->lock));
+
+        if (num_heuristic >= portfolio->num_heuristics)
+            break;
+
+        task_set_struct *task_set = copy_task_set(portfolio->task_set);
+        processor_struct *processor = initialize_processor();
+        allocation_struct *allocation = &(portfolio->allocations[num_heuristic]);
+
+        //Only the first num_cores cores of the processor are used.
+        processor->total_cores = portfolio->num_cores;
+
+        allocation->feasible = allocate_with_heuristic(task_set, processor, portfolio->heuristics[num_heuristic]);
+        save_allocation(task_set, processor, allocation);
+        if (allocation->feasible)
+            estimate_allocation_energy(task_set, processor, allocation);
+        if (allocation->feasible && allocation_mode == PROBABILISTIC_ALLOCATION)
+        {
+            double horizon = find_superhyperperiod(task_set);
+            for (int i = 0; i < processor->total_cores; i++)
+                allocation->mode_switch += find_mode_switch_probability(task_set, i, horizon);
+        }
+
+        free_processor(processor);
+        free_task_set_copy(task_set);
+    }
+
+    fclose(output_file);
+    return NULL;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, number of cores, pointer to the result allocation}
+                The shutdown and non-shutdown tasks are found.
+                1 <= num_cores <= NUM_CORES
+
+    Purpose of the function: Runs the portfolio of allocation heuristics (first/best/worst/mode switch fit, three allocation orders and three MAX_UTIL caps) in parallel threads.
+                             Each allocation is scored with estimate_allocation_energy and the feasible allocation with the lowest energy is selected.
+                             Ties are broken by the larger shutdown fraction. With PROBABILISTIC_ALLOCATION, the allocation with the lowest mode switch probability
+                             (summed over the cores) is selected first, and the energy breaks the ties.
+
+    Postconditions:
+        Output: {1 if a feasible allocation was found, else 0}
+        Result: If a feasible allocation was found, it is stored in result (to be freed with free_allocation).
+*/
+int find_portfolio_allocation(task_set_struct *task_set, int num_cores, allocation_struct *result)
+{
+    int fits[] = {FIRST_FIT, BEST_FIT, WORST_FIT, MODE_SWITCH_FIT};
+    int orders[] = {ORDER_SHUTDOWN, ORDER_CRITICALITY, ORDER_UTILISATION};
+    double caps[] = {0.75, 0.85, 1.00};
+    int i, j, k, best = -1;
+    int num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    portfolio_struct portfolio;
+    pthread_t *threads;
+
+    portfolio.task_set = task_set;
+    portfolio.num_cores = num_cores;
+    portfolio.num_heuristics = 4 * 3 * 3;
+    portfolio.next_heuristic = 0;
+    portfolio.heuristics = malloc(sizeof(heuristic_struct) * portfolio.num_heuristics);
+    portfolio.allocations = malloc(sizeof(allocation_struct) * portfolio.num_heuristics);
+    pthread_mutex_init(&(portfolio.lock), NULL);
+
+    for (i = 0; i < 4; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            for (k = 0; k < 3; k++)
+            {
+                portfolio.heuristics[i * 9 + j * 3 + k].fit = fits[i];
+                portfolio.heuristics[i * 9 + j * 3 + k].order = orders[j];
+                portfolio.heuristics[i * 9 + j * 3 + k].max_util = caps[k];
+            }
+        }
+    }
+
+    num_threads = max_int(1, min_int(num_threads, portfolio.num_heuristics));
+    threads = malloc(sizeof(pthread_t) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, portfolio_worker, &portfolio);
+    }
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    fprintf(output_file, "Allocation portfolio on %d cores:\n", num_cores);
+    for (i = 0; i < portfolio.num_heuristics; i++)
+    {
+        heuristic_struct *heuristic = &(portfolio.heuristics[i]);
+        allocation_struct *allocation = &(portfolio.allocations[i]);
+
+        fprintf(output_file, "Fit: %s, Order: %s, Max util: %.2lf | ",
+                heuristic->fit == FIRST_FIT ? "FIRST" : (heuristic->fit == BEST_FIT ? "BEST" : (heuristic->fit == WORST_FIT ? "WORST" : "MODE SWITCH")),
+                heuristic->order == ORDER_SHUTDOWN ? "SHUTDOWN" : (heuristic->order == ORDER_CRITICALITY ? "CRITICALITY" : "UTILISATION"),
+                heuristic->max_util);
+        if (allocation->feasible == 0)
+        {
+            fprintf(output_file, "Insufficient number of cores\n");
+            continue;
+        }
+        fprintf(output_file, "Energy: %.5lf, Shutdown: %.5lf", allocation->energy, allocation->shutdown);
+        if (allocation_mode == PROBABILISTIC_ALLOCATION)
+            fprintf(output_file, ", Mode switch: %.5lf", allocation->mode_switch);
+        fprintf(output_file, "\n");
+
+        if (best != -1 && allocation->mode_switch != portfolio.allocations[best].mode_switch)
+        {
+            if (allocation->mode_switch < portfolio.allocations[best].mode_switch)
+                best = i;
+        }
+        else if (best == -1 || allocation->energy < portfolio.allocations[best].energy ||
+                 (allocation->energy == portfolio.allocations[best].energy && allocation->shutdown > portfolio.allocations[best].shutdown))
+        {
+            best = i;
+        }
+    }
+
+    if (best != -1)
+    {
+        fprintf(output_file, "Selected heuristic %d\n", best);
+        *result = portfolio.allocations[best];
+    }
+
+    for (i = 0; i < portfolio.num_heuristics; i++)
+    {
+        if (i != best)
+            free_allocation(&(portfolio.allocations[i]));
+    }
+    free(portfolio.allocations);
+    free(portfolio.heuristics);
+    free(threads);
+    pthread_mutex_destroy(&(portfolio.lock));
+
+    return (best != -1);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, allocation file}
+                The shutdown and non-shutdown tasks are found.
+
+    Purpose of the function: Selects an allocation with find_portfolio_allocation, applies it to the taskset and writes it in the allocation file.
+
+    Postconditions:
+        Output: {1 if a feasible allocation was found, else 0}
+*/
+int allocate_tasks_portfolio(task_set_struct *task_set, processor_struct *processor, FILE *allocation_file)
+{
+    allocation_struct allocation;
+
+    if (find_portfolio_allocation(task_set, NUM_CORES, &allocation) == 0)
+        return 0;
+
+    apply_allocation(task_set, processor, &allocation, allocation_file);
+    free_allocation(&allocation);
+    return 1;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to the result allocation}
+                The shutdown and non-shutdown tasks are found.
+
+    Purpose of the function: Finds the minimum number of cores on which one of the heuristics of the portfolio allocates all the tasks.
+                             The number of cores is first doubled (1, 2, 4, ...) until the portfolio succeeds, and then binary searched between the last failing
+                             and the first succeeding number of cores. At most NUM_CORES cores are tried.
+
+    Postconditions:
+        Output: {The minimum number of cores, 0 if the tasks cannot be allocated on NUM_CORES cores}
+        Result: The allocation on the minimum number of cores is stored in result (to be freed with free_allocation).
+*/
+int find_minimum_cores(task_set_struct *task_set, allocation_struct *result)
+{
+    int low = 0, high = 1, mid;
+    allocation_struct allocation;
+
+    //Exponential search for a feasible number of cores.
+    while (1)
+    {
+        fprintf(output_file, "Trying %d cores\n", high);
+        if (find_portfolio_allocation(task_set, high, &allocation) == 1)
+        {
+            *result = allocation;
+            break;
+        }
+
+        low = high;
+        if (high == NUM_CORES)
+            return 0;
+        high = min_int(2 * high, NUM_CORES);
+    }
+
+    //Binary search between low (not feasible) and high (feasible).
+    while (high - low > 1)
+    {
+        mid = (low + high) / 2;
+        fprintf(output_file, "Trying %d cores\n", mid);
+        if (find_portfolio_allocation(task_set, mid, &allocation) == 1)
+        {
+            free_allocation(result);
+            *result = allocation;
+            high = mid;
+        }
+        else
+        {
+            low = mid;
+        }
+    }
+
+    return high;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, allocation file}
+                The shutdown and non-shutdown tasks are found.
+
+    Purpose of the function: Finds the minimum number of cores with find_minimum_cores, reports it and applies the allocation on that number of cores to the taskset.
+                             The remaining cores of the processor are left empty and are shutdown by the scheduler.
+
+    Postconditions:
+        Output: {1 if a feasible allocation was found, else 0}
+*/
+int allocate_tasks_minimum_cores(task_set_struct *task_set, processor_struct *processor, FILE *allocation_file)
+{
+    allocation_struct allocation;
+    int num_cores = find_minimum_cores(task_set, &allocation);
+
+    if (num_cores == 0)
+    {
+        printf("Tasks cannot be allocated on %d cores\n", NUM_CORES);
+        return 0;
+    }
+
+    printf("Minimum number of cores: %d\n", num_cores);
+    fprintf(output_file, "Minimum number of cores: %d\n", num_cores);
+    apply_allocation(task_set, processor, &allocation, allocation_file);
+    free_allocation(&allocation);
+    return 1;
+}
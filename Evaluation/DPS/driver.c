@@ -5,6 +5,29 @@ int main(int argc, char *argv[])
     FILE *statistics_file;
     MAX_CRITICALITY_LEVELS = 4;
 
+    //The allocation heuristic portfolio is used if "portfolio" is passed as argument, the simulation-based optimizer if "optimize" is passed,
+    //the search for the minimum number of cores if "mincores" is passed and the portfolio with the lowest mode switch probability if "probabilistic" is passed.
+    allocation_mode = DEFAULT_ALLOCATION;
+    if (argc > 1 && strcmp(argv[1], "portfolio") == 0)
+    {
+        allocation_mode = PORTFOLIO_ALLOCATION;
+    }
+    else if (argc > 1 && strcmp(argv[1], "optimize") == 0)
+    {
+        allocation_mode = OPTIMIZED_ALLOCATION;
+    }
+    else if (argc > 1 && strcmp(argv[1], "mincores") == 0)
+    {
+        allocation_mode = MINIMUM_CORES_ALLOCATION;
+    }
+    else if (argc > 1 && strcmp(argv[1], "probabilistic") == 0)
+    {
+        allocation_mode = PROBABILISTIC_ALLOCATION;
+    }
+
+    //The scheduling options are read by parse_options (common/scheduler.c).
+    parse_options(argc, argv);
+
     //get_task_set function - takes input from input file. Pass file pointer to the function.
     task_set_struct *task_set = get_taskset();
     processor_struct *processor = initialize_processor();
@@ -6,13 +6,12 @@ processor_struct *initialize_processor()
     int i;
 
     processor->total_cores = NUM_CORES;
+    processor->crit_level = 0;
     processor->cores = malloc(sizeof(core_struct) * (processor->total_cores));
 
     for (i = 0; i < processor->total_cores; i++)
     {
-        processor->cores[i].ready_queue = (job_queue_struct *)malloc(sizeof(job_queue_struct));
-        processor->cores[i].ready_queue->num_jobs = 0;
-        processor->cores[i].ready_queue->job_list_head = NULL;
+        processor->cores[i].ready_queue = initialize_job_queue();
         processor->cores[i].curr_exec_job = NULL;
         processor->cores[i].total_time = 0.0f;
         processor->cores[i].total_idle_time = 0.0f;
@@ -22,12 +21,15 @@ processor_struct *initialize_processor()
         processor->cores[i].frequency = 1.00;
         processor->cores[i].x_factor = 0.00;
         processor->cores[i].threshold_crit_lvl = -1;
+        processor->cores[i].crit_level = 0;
+        processor->cores[i].mode_switch_time = 0.00;
 
         processor->cores[i].rem_util = (double *)malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
         for (int j = 0; j < MAX_CRITICALITY_LEVELS; j++)
         {
             processor->cores[i].rem_util[j] = 1.00;
         }
+        processor->cores[i].total_utilisation = (double *)calloc(MAX_CRITICALITY_LEVELS * MAX_CRITICALITY_LEVELS, sizeof(double));
     }
 
     return processor;
@@ -40,6 +42,13 @@ int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *process
     FILE* cores_file;
     cores_file = fopen("../input_cores.txt", "r");
 
+    //The cores are read from the allocation file along with the taskset. Build the task index of each core from them.
+    build_task_index(task_set);
+
+    //The per-task virtual deadline factors found by the allocation, if any.
+    load_deadline_factors(task_set);
+
+
     for (i = 0; i < processor->total_cores; i++)
     {
         fscanf(cores_file, "%lf%d", &(processor->cores[i].x_factor), &(processor->cores[i].threshold_crit_lvl));
@@ -55,6 +64,10 @@ int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *process
         }
     }
     fprintf(output_file, "\n");
+
+    //The virtual deadlines are set. Build the task table of each core used by the scheduler.
+    build_task_table(task_set);
+
     fclose(cores_file);
     return 1;
 }
\ No newline at end of file
@@ -5,6 +5,9 @@ int main(int argc, char *argv[])
     FILE *statistics_file;
     MAX_CRITICALITY_LEVELS = 1;
 
+    //The scheduling options are read by parse_options (common/scheduler.c).
+    parse_options(argc, argv);
+
     //get_task_set function - takes input from input file. Pass file pointer to the function.
     task_set_struct *task_set = get_taskset();
     processor_struct *processor = initialize_processor();
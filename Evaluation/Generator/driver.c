@@ -0,0 +1,159 @@
+#include "../common/functions.h"
+
+/*
+    Taskset generator. Usage:
+        ./test bulk file count utilisation tasks levels harmonic|nonharmonic [seed]
+            Generates count tasksets and writes them in the binary format to file. The utilisation is normalized (total utilisation at the lowest level / NUM_CORES).
+            Taskset i uses the stream i of the generator, so the same seed always gives the same file.
+        ./test text file index [levels]
+            Writes taskset number index (from 0) of the binary file to ../input_mcs.txt, ../input_rts.txt and ../input_times.txt.
+        ./test times [models [seed]]
+            Writes the execution times of the taskset in ../input_mcs.txt to ../input_times.txt, as create_times does. The execution time model of each task
+            is read from the models file (see load_exec_models); without it, every task uses the model of create_times.c.
+    Without arguments, 100000 tasksets with utilisation 0.5, 16 tasks and 4 levels are written to tasksets.bin.
+*/
+int main(int argc, char *argv[])
+{
+    generator_struct generator;
+    rng_struct rng, taskset_rng;
+    task_set_struct *task_set = NULL;
+    FILE *file, *mcs_file, *rts_file, *times_file;
+    char *filename = "tasksets.bin";
+    int count = 100000, num_tasks = 16, index, i, generated = 0;
+    double utilisation = 0.50, elapsed;
+    int period_set = NON_HARMONIC_PERIODS;
+    unsigned long long seed = 1;
+    struct timespec start, end;
+    MAX_CRITICALITY_LEVELS = 4;
+
+    if (argc >= 2 && strcmp(argv[1], "text") == 0)
+    {
+        if (argc < 4)
+        {
+            printf("Usage: ./test text file index [levels]\n");
+            return 0;
+        }
+        index = atoi(argv[3]);
+        if (argc > 4)
+            MAX_CRITICALITY_LEVELS = atoi(argv[4]);
+
+        file = fopen(argv[2], "rb");
+        if (file == NULL)
+        {
+            printf("ERROR: Cannot open %s\n", argv[2]);
+            return 0;
+        }
+        for (i = 0; i <= index; i++)
+        {
+            task_set = read_taskset_binary(file);
+            if (task_set == NULL)
+            {
+                printf("ERROR: The file has only %d tasksets\n", i);
+                return 0;
+            }
+            if (i < index)
+                free_generated_taskset(task_set, 1);
+        }
+        fclose(file);
+
+        mcs_file = fopen("../input_mcs.txt", "w");
+        rts_file = fopen("../input_rts.txt", "w");
+        times_file = fopen("../input_times.txt", "w");
+        write_taskset_text(task_set, mcs_file, rts_file, times_file);
+        fclose(mcs_file);
+        fclose(rts_file);
+        fclose(times_file);
+        free_generated_taskset(task_set, 1);
+        return 0;
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "times") == 0)
+    {
+        if (argc > 3)
+            seed = strtoull(argv[3], NULL, 10);
+
+        mcs_file = fopen("../input_mcs.txt", "r");
+        if (mcs_file == NULL || (task_set = read_taskset_text(mcs_file)) == NULL)
+        {
+            printf("ERROR: Cannot read input file ../input_mcs.txt\n");
+            return 0;
+        }
+        fclose(mcs_file);
+
+        if (argc > 2)
+        {
+            file = fopen(argv[2], "r");
+            if (file == NULL || !load_exec_models(file, task_set))
+            {
+                printf("ERROR: Cannot read the execution time models from %s\n", argv[2]);
+                return 0;
+            }
+            fclose(file);
+        }
+
+        rng = rng_init(seed);
+        generate_execution_times(task_set, &rng);
+
+        times_file = fopen("../input_times.txt", "w");
+        write_execution_times_text(task_set, times_file);
+        fclose(times_file);
+
+        free_exec_models(task_set);
+        free_generated_taskset(task_set, 1);
+        return 0;
+    }
+
+    if (argc >= 8 && strcmp(argv[1], "bulk") == 0)
+    {
+        filename = argv[2];
+        count = atoi(argv[3]);
+        utilisation = atof(argv[4]);
+        num_tasks = atoi(argv[5]);
+        MAX_CRITICALITY_LEVELS = atoi(argv[6]);
+        period_set = (strcmp(argv[7], "harmonic") == 0) ? HARMONIC_PERIODS : NON_HARMONIC_PERIODS;
+        if (argc > 8)
+            seed = strtoull(argv[8], NULL, 10);
+    }
+    else if (argc != 1)
+    {
+        printf("Usage: ./test bulk file count utilisation tasks levels harmonic|nonharmonic [seed]\n");
+        printf("       ./test text file index [levels]\n");
+        printf("       ./test times [models [seed]]\n");
+        return 0;
+    }
+
+    if (count <= 0 || utilisation <= 0 || num_tasks <= 0 || MAX_CRITICALITY_LEVELS <= 0 || MAX_CRITICALITY_LEVELS > MAX_GENERATOR_LEVELS)
+    {
+        printf("ERROR: Invalid generator parameters\n");
+        return 0;
+    }
+
+    file = fopen(filename, "wb");
+    if (file == NULL)
+    {
+        printf("ERROR: Cannot open %s. Make sure right permissions are provided\n", filename);
+        return 0;
+    }
+
+    initialize_generator_struct(&generator, num_tasks, period_set);
+    rng = rng_init(seed);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < count; i++)
+    {
+        taskset_rng = rng_split(&rng, i);
+        task_set = generate_taskset(&generator, utilisation, &taskset_rng);
+        if (task_set == NULL)
+            continue;
+
+        write_taskset_binary(file, task_set);
+        free_generated_taskset(task_set, 1);
+        generated++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fclose(file);
+
+    elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Generated %d tasksets (%d discarded) in %.2lf s (%.0lf tasksets per minute)\n", generated, count - generated, elapsed, generated * 60 / elapsed);
+    return 0;
+}
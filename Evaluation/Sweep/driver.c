@@ -0,0 +1,58 @@
+#include "../common/functions.h"
+
+/*
+    Breakdown-utilisation sweep. Usage: ./test [min_util max_util step samples tasks]
+    The results are written in sweep.csv.
+*/
+int main(int argc, char *argv[])
+{
+    double min_util = 0.10, max_util = 0.90, step = 0.10;
+    int num_samples = 20, num_tasks = 16, num_points;
+    FILE *csv_file;
+    MAX_CRITICALITY_LEVELS = 4;
+    //No scheduling options are taken: parse_options sets the defaults.
+    parse_options(0, NULL);
+
+    if (argc == 6)
+    {
+        min_util = atof(argv[1]);
+        max_util = atof(argv[2]);
+        step = atof(argv[3]);
+        num_samples = atoi(argv[4]);
+        num_tasks = atoi(argv[5]);
+    }
+    else if (argc != 1)
+    {
+        printf("Usage: ./test [min_util max_util step samples tasks]\n");
+        return 0;
+    }
+
+    if (min_util <= 0 || max_util < min_util || step <= 0 || num_samples <= 0 || num_tasks <= 0)
+    {
+        printf("ERROR: Invalid sweep parameters\n");
+        return 0;
+    }
+
+    //Set the frequency values.
+    frequency[0] = 0.5;
+    frequency[1] = 0.6;
+    frequency[2] = 0.75;
+    frequency[3] = 0.9;
+    frequency[4] = 1.00;
+
+    printf("Starting sweep\n");
+    sweep_point_struct *points = run_sweep(min_util, max_util, step, num_samples, num_tasks, &num_points);
+
+    csv_file = fopen("sweep.csv", "w");
+    if (csv_file == NULL)
+    {
+        printf("ERROR: Cannot open sweep.csv. Make sure right permissions are provided\n");
+        return 0;
+    }
+    write_sweep_csv(csv_file, points, num_points);
+    fclose(csv_file);
+    free(points);
+
+    printf("Results written in sweep.csv\n");
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include "../common/functions.h"
+#include <pthread.h>
+
+//Seed of the generated tasksets. The taskset of sample s of utilisation level p uses the stream p * samples + s of the generator.
+#define SWEEP_SEED 1
+
+/*
+    Data shared by the threads of the sweep. Each thread picks the next (utilisation level, sample) pair from next_item.
+*/
+typedef struct sweep_struct
+{
+    sweep_point_struct *points;
+    int num_points;
+    int num_samples;
+    generator_struct generator;
+    rng_struct rng;
+    int next_item;
+    pthread_mutex_t lock;
+} sweep_struct;
+
+/*
+    Preconditions:
+        Input: {pointer to the sweep, pointer to the sweep point, random number generator of the taskset}
+
+    Purpose of the function: Generates one taskset for the utilisation of the point and allocates it once with the default DPS allocation
+                             (first fit, exceptional/non-shutdown/shutdown order, MAX_UTIL 0.85). The same allocation is then scheduled with every algorithm
+                             (run_all_algorithms).
+
+    Postconditions:
+        Output: {void}
+        Result: The statistics of the accepted runs are added to the point. The caller holds no lock; the point is updated under the sweep lock.
+*/
+void run_sweep_sample(sweep_struct *sweep, sweep_point_struct *point, rng_struct *rng)
+{
+    task_set_struct *task_set = generate_taskset(&(sweep->generator), point->utilisation, rng);
+    task_set_struct *alloc_task_set;
+    processor_struct *processor;
+    allocation_struct allocation;
+    heuristic_struct heuristic = {FIRST_FIT, ORDER_SHUTDOWN, 0.85};
+    simulation_result_struct results[NUM_ALGORITHMS];
+    int num_algo;
+
+    //A taskset for which UUniFast-discard found no valid draw is counted as not accepted by any algorithm.
+    if (task_set == NULL)
+    {
+        pthread_mutex_lock(&(sweep->lock));
+        point->num_tasksets++;
+        pthread_mutex_unlock(&(sweep->lock));
+        return;
+    }
+
+    find_shutdown_tasks(task_set);
+
+    alloc_task_set = copy_task_set(task_set);
+    processor = initialize_processor();
+    allocation.feasible = allocate_with_heuristic(alloc_task_set, processor, heuristic);
+    save_allocation(alloc_task_set, processor, &allocation);
+    free_processor(processor);
+    free_task_set_copy(alloc_task_set);
+
+    if (allocation.feasible)
+        run_all_algorithms(task_set, &allocation, results);
+
+    pthread_mutex_lock(&(sweep->lock));
+    point->num_tasksets++;
+    for (num_algo = 0; num_algo < NUM_ALGORITHMS && allocation.feasible; num_algo++)
+    {
+        if (!results[num_algo].completed)
+            continue;
+
+        point->accepted[num_algo]++;
+        point->active_time[num_algo] += results[num_algo].active_time;
+        point->idle_time[num_algo] += results[num_algo].idle_time;
+        point->shutdown_time[num_algo] += results[num_algo].shutdown_time;
+        point->discarded_exec[num_algo] += results[num_algo].discarded_exec;
+        point->discarded_avail[num_algo] += results[num_algo].discarded_avail;
+    }
+    pthread_mutex_unlock(&(sweep->lock));
+
+    free_allocation(&allocation);
+    free_generated_taskset(task_set, 1);
+}
+
+/*
+    Function run by each thread of the sweep. The logs of the thread are discarded.
+*/
+void *sweep_worker(void *arg)
+{
+    sweep_struct *sweep = (sweep_struct *)arg;
+    rng_struct rng;
+    int item;
+    FILE *null_file = discard_thread_output();
+
+    while (1)
+    {
+        pthread_mutex_lock(&(sweep->lock));
+        item = sweep->next_item++;
+        pthread_mutex_unlock(&(sweep->lock));
+
+        if (item >= sweep->num_points * sweep->num_samples)
+            break;
+
+        rng = rng_split(&(sweep->rng), item);
+        run_sweep_sample(sweep, &(sweep->points[item / sweep->num_samples]), &rng);
+    }
+
+    fclose(null_file);
+    return NULL;
+}
+
+/*
+    Preconditions:
+        Input: {first and last utilisation level, step, number of tasksets per level, number of tasks per taskset}
+                0 < min_util <= max_util, step > 0, num_samples > 0, num_tasks > 0
+
+    Purpose of the function: Runs the sweep: for each utilisation level, num_samples tasksets are generated, allocated once and scheduled with every algorithm.
+                             All the (level, taskset) pairs are processed in parallel threads. Nothing is read from or written to the input files.
+
+    Postconditions:
+        Output: {Array of the results of each utilisation level}
+        Result: *num_points is the number of utilisation levels.
+*/
+sweep_point_struct *run_sweep(double min_util, double max_util, double step, int num_samples, int num_tasks, int *num_points)
+{
+    sweep_struct sweep;
+    pthread_t *threads;
+    int i, num_threads = max_int(1, sysconf(_SC_NPROCESSORS_ONLN));
+
+    sweep.num_points = (int)floor((max_util - min_util) / step + 1e-9) + 1;
+    sweep.num_samples = num_samples;
+    initialize_generator_struct(&(sweep.generator), num_tasks, NON_HARMONIC_PERIODS);
+    sweep.rng = rng_init(SWEEP_SEED);
+    sweep.next_item = 0;
+    sweep.points = calloc(sweep.num_points, sizeof(sweep_point_struct));
+    pthread_mutex_init(&(sweep.lock), NULL);
+
+    for (i = 0; i < sweep.num_points; i++)
+    {
+        sweep.points[i].utilisation = min_util + i * step;
+    }
+
+    threads = malloc(sizeof(pthread_t) * num_threads);
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_create(&threads[i], NULL, sweep_worker, &sweep);
+    }
+    for (i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    free(threads);
+    pthread_mutex_destroy(&(sweep.lock));
+    *num_points = sweep.num_points;
+    return sweep.points;
+}
+
+/*
+    Preconditions:
+        Input: {file pointer to the CSV file, results of the sweep, number of utilisation levels}
+
+    Purpose of the function: Writes one line per utilisation level and algorithm with the acceptance ratio, the average active, idle and shutdown time
+                             per accepted taskset, the energy (computed as in export_csv.c) and the ratio of the discarded job time executed to the time available.
+
+    Postconditions:
+        Output: {void}
+*/
+void write_sweep_csv(FILE *csv_file, sweep_point_struct *points, int num_points)
+{
+    int i, num_algo;
+
+    fprintf(csv_file, "utilisation,algorithm,tasksets,accepted,acceptance_ratio,active_time,idle_time,shutdown_time,energy,discarded_job_ratio\n");
+    for (i = 0; i < num_points; i++)
+    {
+        for (num_algo = 0; num_algo < NUM_ALGORITHMS; num_algo++)
+        {
+            sweep_point_struct *point = &points[i];
+            int accepted = point->accepted[num_algo];
+            double at = point->active_time[num_algo], it = point->idle_time[num_algo];
+            double energy = find_energy(at, it);
+            double discarded_ratio = (point->discarded_avail[num_algo] > 0.00) ? point->discarded_exec[num_algo] / point->discarded_avail[num_algo] : 0.00;
+
+            fprintf(csv_file, "%.2lf,%s,%d,%d,%.4lf,%.2lf,%.2lf,%.2lf,%.4lf,%.4lf\n",
+                    point->utilisation,
+                    find_algorithm_name(num_algo),
+                    point->num_tasksets,
+                    accepted,
+                    (point->num_tasksets > 0) ? (double)accepted / point->num_tasksets : 0.00,
+                    (accepted > 0) ? at / accepted : 0.00,
+                    (accepted > 0) ? it / accepted : 0.00,
+                    (accepted > 0) ? point->shutdown_time[num_algo] / accepted : 0.00,
+                    energy,
+                    discarded_ratio);
+        }
+    }
+}
@@ -1,5 +1,24 @@
 #include "functions.h"
 
+__thread FILE *output_file;
+__thread FILE *output[NUM_CORES];
+__thread stats_struct *stats;
+
+double frequency[FREQUENCY_LEVELS];
+int MAX_CRITICALITY_LEVELS;
+int allocation_mode;
+int demand_allocation;
+double simulation_horizon;
+double convergence_window;
+double convergence_tolerance;
+int discarded_migration;
+int discarded_capacity;
+int per_core_mode;
+int mode_return;
+int knapsack_readmission;
+double *readmission_value;
+int mode_check;
+
 int randnum()
 {
     int num = 4;
@@ -109,13 +128,28 @@ void print_job_list(int core_no, job *job_list_head)
                 job_temp->execution_time,
                 job_temp->rem_exec_time,
                 job_temp->WCET_counter,
-                job_temp->absolute_deadline);
+                find_job_deadline(job_temp));
         job_temp = job_temp->next;
     }
 
     return;
 }
 
+/*
+    Function to print a job queue, from the list of the highest criticality level to the lowest (the order of the discarded queue)
+*/
+void print_job_queue(int core_no, job_queue_struct *queue)
+{
+    int level;
+
+    for (level = MAX_CRITICALITY_LEVELS - 1; level >= 0; level--)
+    {
+        print_job_list(core_no, queue->level_head[level]);
+    }
+
+    return;
+}
+
 /*
     Function to print the utilisation matrix. 
 */
@@ -161,7 +195,7 @@ int compare_jobs(job *A, job *B)
     else if (A == NULL || B == NULL)
         return 0;
 
-    if (A->task_number == B->task_number && A->absolute_deadline == B->absolute_deadline)
+    if (A->task_number == B->task_number && A->release_time == B->release_time)
         return 1;
     return 0;
 }
@@ -194,34 +228,51 @@ double find_actual_execution_time(double exec_time, int task_crit_lvl, int core_
 
 void set_virtual_deadlines(task_set_struct **task_set, int core_no, double x, int k)
 {
-    int num_task;
+    int num_task, crit_level, task_number;
+    task_index_struct *index = &((*task_set)->core_index[core_no]);
 
-    for (num_task = 0; num_task < (*task_set)->total_tasks; num_task++)
+    for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
     {
-        if ((*task_set)->task_list[num_task].core == core_no)
+        for (num_task = 0; num_task < index->num_tasks[crit_level]; num_task++)
         {
-            if ((*task_set)->task_list[num_task].criticality_lvl <= k)
+            task_number = index->task_list[crit_level][num_task];
+            if (crit_level <= k)
             {
-                (*task_set)->task_list[num_task].virtual_deadline = (*task_set)->task_list[num_task].relative_deadline;
+                (*task_set)->task_list[task_number].virtual_deadline = (*task_set)->task_list[task_number].relative_deadline;
             }
             else
             {
-                (*task_set)->task_list[num_task].virtual_deadline = x * (*task_set)->task_list[num_task].relative_deadline;
+                //A task with a tuned virtual deadline factor uses it instead of the x-factor of the core.
+                double factor = ((*task_set)->task_list[task_number].deadline_factor > 0.00) ? (*task_set)->task_list[task_number].deadline_factor : x;
+                (*task_set)->task_list[task_number].virtual_deadline = factor * (*task_set)->task_list[task_number].relative_deadline;
             }
+            update_task_table(*task_set, task_number);
         }
     }
     return;
 }
 
-void reset_virtual_deadlines(task_set_struct **task_set, int num_core, int k)
+/*
+    Function to reset the virtual deadlines of the tasks of the core with criticality level greater than k to their relative deadlines.
+    Returns 1 if any virtual deadline changed, i.e., the deadlines of the jobs of these tasks moved.
+*/
+int reset_virtual_deadlines(task_set_struct **task_set, int num_core, int k)
 {
-    int i;
-    for (i = 0; i < (*task_set)->total_tasks; i++)
+    int i, crit_level, task_number, changed = 0;
+    task_index_struct *index = &((*task_set)->core_index[num_core]);
+
+    for (crit_level = k + 1; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
     {
-        if ((*task_set)->task_list[i].criticality_lvl > k && (*task_set)->task_list[i].core == num_core)
-            (*task_set)->task_list[i].virtual_deadline = (*task_set)->task_list[i].relative_deadline;
+        for (i = 0; i < index->num_tasks[crit_level]; i++)
+        {
+            task_number = index->task_list[crit_level][i];
+            if ((*task_set)->task_list[task_number].virtual_deadline != (*task_set)->task_list[task_number].relative_deadline)
+                changed = 1;
+            (*task_set)->task_list[task_number].virtual_deadline = (*task_set)->task_list[task_number].relative_deadline;
+            update_task_table(*task_set, task_number);
+        }
     }
-    return;
+    return changed;
 }
 
 void set_execution_times(job* curr_job, double frequency)
@@ -238,6 +289,9 @@ void reset_execution_times(job* curr_job, double frequency)
     curr_job->WCET_counter *= frequency;
 }
 
+/*
+    Function to check whether no core has a job to execute (all the ready queues are empty).
+*/
 int check_all_cores(processor_struct *processor)
 {
     int flag = 1;
@@ -254,21 +308,106 @@ int check_all_cores(processor_struct *processor)
 
 int find_max_level(processor_struct *processor, task_set_struct *task_set)
 {
-    int max_crit_level = MAX_CRITICALITY_LEVELS - 1;
+    int max_crit_level = 0;
 
     for (int i = 0; i < processor->total_cores; i++)
     {
-        job *temp = processor->cores[i].ready_queue->job_list_head;
-
-        while (temp)
+        //The jobs are kept by criticality level, so only the lists above the current maximum need to be checked.
+        for (int level = max_crit_level + 1; level < MAX_CRITICALITY_LEVELS; level++)
         {
-            max_crit_level = (max_crit_level > task_set->task_list[temp->task_number].criticality_lvl) ? max_crit_level : task_set->task_list[temp->task_number].criticality_lvl;
-            temp = temp->next;
+            if (processor->cores[i].ready_queue->level_head[level] != NULL)
+                max_crit_level = level;
         }
     }
     return max_crit_level;
 }
 
+/*
+    Preconditions:
+        Input: {pointer to processor, pointer to taskset}
+
+    Purpose of the function: Checks the criticality levels of the cores after a criticality change:
+                                the budgets of the jobs in the ready queue of each core are counted at the level of the core (mode_level),
+                                the job executed by each core is the head of its ready queue (the deadlines of the queued jobs did not move),
+                                the level of the processor is the highest level of the cores, and all the cores have the same level unless per_core_mode is set,
+                                a core above its threshold level executes the tasks above the threshold with their relative deadlines,
+                                the running numbers of the ready jobs of each level (ready_jobs), if they are kept, match the ready queues.
+
+    Postconditions:
+        Output: {The number of violations found, each of them printed to the output file}
+*/
+int check_core_modes(processor_struct *processor, task_set_struct *task_set)
+{
+    int num_core, crit_level, i, task_number, max_crit_level = 0, violations = 0, num_jobs;
+    core_struct *core;
+    task_index_struct *index;
+    job *curr;
+
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        core = &(processor->cores[num_core]);
+        max_crit_level = max_int(max_crit_level, core->crit_level);
+
+        if (core->ready_queue->mode_level != core->crit_level)
+        {
+            fprintf(output_file, "Mode check: core %d has level %d, its ready queue has level %d\n", num_core, core->crit_level, core->ready_queue->mode_level);
+            violations++;
+        }
+        if (core->curr_exec_job != NULL && core->curr_exec_job != find_earliest_job(core->ready_queue))
+        {
+            fprintf(output_file, "Mode check: job %d,%d executed by core %d is not the head of its ready queue\n", core->curr_exec_job->task_number, core->curr_exec_job->job_number, num_core);
+            violations++;
+        }
+        if (!per_core_mode && core->crit_level != processor->crit_level)
+        {
+            fprintf(output_file, "Mode check: core %d has level %d, the processor has level %d\n", num_core, core->crit_level, processor->crit_level);
+            violations++;
+        }
+        if (core->crit_level <= core->threshold_crit_lvl)
+            continue;
+
+        index = &(task_set->core_index[num_core]);
+        for (crit_level = core->threshold_crit_lvl + 1; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            for (i = 0; i < index->num_tasks[crit_level]; i++)
+            {
+                task_number = index->task_list[crit_level][i];
+                if (task_set->task_list[task_number].virtual_deadline != task_set->task_list[task_number].relative_deadline)
+                {
+                    fprintf(output_file, "Mode check: task %d of core %d has a virtual deadline above the threshold level\n", task_number, num_core);
+                    violations++;
+                }
+            }
+        }
+    }
+
+    if (max_crit_level != processor->crit_level)
+    {
+        fprintf(output_file, "Mode check: the highest level of the cores is %d, the processor has level %d\n", max_crit_level, processor->crit_level);
+        violations++;
+    }
+
+    for (i = 0; processor->ready_jobs != NULL && i < processor->total_cores * MAX_CRITICALITY_LEVELS; i++)
+    {
+        num_jobs = 0;
+        for (num_core = 0; num_core < processor->total_cores; num_core++)
+        {
+            for (curr = processor->cores[num_core].ready_queue->level_head[i % MAX_CRITICALITY_LEVELS]; curr != NULL; curr = curr->next)
+            {
+                if (curr->job_task->core == i / MAX_CRITICALITY_LEVELS)
+                    num_jobs++;
+            }
+        }
+        if (num_jobs != processor->ready_jobs[i])
+        {
+            fprintf(output_file, "Mode check: %d ready jobs of level %d of the tasks of core %d, counted %d\n", num_jobs, i % MAX_CRITICALITY_LEVELS, i / MAX_CRITICALITY_LEVELS, processor->ready_jobs[i]);
+            violations++;
+        }
+    }
+
+    return violations;
+}
+
 stats_struct* initialize_stats_struct()
 {
     stats = malloc(sizeof(stats_struct));
@@ -283,6 +422,247 @@ stats_struct* initialize_stats_struct()
     stats->total_discarded_jobs = calloc(NUM_CORES, sizeof(int));
     stats->total_discarded_jobs_executed = calloc(NUM_CORES, sizeof(double));
     stats->total_discarded_jobs_available = calloc(NUM_CORES, sizeof(double));
+    stats->peak_discarded_jobs = 0;
+    stats->total_evicted_jobs = 0;
+    stats->total_mode_switches = calloc(NUM_CORES, sizeof(int));
+    stats->total_mode_returns = calloc(NUM_CORES, sizeof(int));
+    stats->total_raised_time = calloc(NUM_CORES, sizeof(double));
 
     return stats;
-}
\ No newline at end of file
+}
+
+void free_stats_struct(stats_struct *stats)
+{
+    free(stats->total_active_energy);
+    free(stats->total_idle_energy);
+    free(stats->total_shutdown_time);
+    free(stats->total_arrival_points);
+    free(stats->total_completion_points);
+    free(stats->total_criticality_change_points);
+    free(stats->total_wakeup_points);
+    free(stats->total_context_switches);
+    free(stats->total_discarded_jobs);
+    free(stats->total_discarded_jobs_executed);
+    free(stats->total_discarded_jobs_available);
+    free(stats->total_mode_switches);
+    free(stats->total_mode_returns);
+    free(stats->total_raised_time);
+    free(stats);
+}
+/*
+    Preconditions:
+        Input: {pointer to taskset}
+                task_set!=NULL
+
+    Purpose of the function: Creates an empty task index for each core. Each criticality level of a core can hold all the tasks of the taskset.
+
+    Postconditions:
+        Output: {void}
+        Result: task_set->core_index contains NUM_CORES empty task indices.
+*/
+void initialize_task_index(task_set_struct *task_set)
+{
+    int num_core, crit_level;
+
+    task_set->core_index = malloc(sizeof(task_index_struct) * NUM_CORES);
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        task_set->core_index[num_core].num_tasks = calloc(MAX_CRITICALITY_LEVELS, sizeof(int));
+        task_set->core_index[num_core].task_list = malloc(sizeof(int *) * MAX_CRITICALITY_LEVELS);
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            task_set->core_index[num_core].task_list[crit_level] = malloc(sizeof(int) * task_set->total_tasks);
+        }
+    }
+    return;
+}
+
+/*
+    Function to add a task to the task index of the core. The tasks of each criticality level are kept in increasing order of task number,
+    so that the index is traversed in the same order as the task list.
+*/
+void add_task_to_index(task_set_struct *task_set, int task_number, int core_no)
+{
+    int crit_level = task_set->task_list[task_number].criticality_lvl;
+    int *num_tasks = &(task_set->core_index[core_no].num_tasks[crit_level]);
+    int *task_list = task_set->core_index[core_no].task_list[crit_level];
+    int i;
+
+    for (i = *num_tasks; i > 0 && task_list[i - 1] > task_number; i--)
+    {
+        task_list[i] = task_list[i - 1];
+    }
+    task_list[i] = task_number;
+    (*num_tasks)++;
+
+    return;
+}
+
+/*
+    Function to remove a task from the task index of the core.
+*/
+void remove_task_from_index(task_set_struct *task_set, int task_number, int core_no)
+{
+    int crit_level = task_set->task_list[task_number].criticality_lvl;
+    int *num_tasks = &(task_set->core_index[core_no].num_tasks[crit_level]);
+    int *task_list = task_set->core_index[core_no].task_list[crit_level];
+    int i;
+
+    for (i = 0; i < *num_tasks && task_list[i] != task_number; i++)
+        ;
+    if (i == *num_tasks)
+        return;
+
+    for (; i < *num_tasks - 1; i++)
+    {
+        task_list[i] = task_list[i + 1];
+    }
+    (*num_tasks)--;
+
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset}
+                task_set!=NULL
+
+    Purpose of the function: Builds the task index of every core from the core field of the tasks. Tasks which are not allocated to any core are skipped.
+
+    Postconditions:
+        Output: {void}
+*/
+void build_task_index(task_set_struct *task_set)
+{
+    int i;
+
+    initialize_task_index(task_set);
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        if (task_set->task_list[i].core >= 0 && task_set->task_list[i].core < NUM_CORES)
+        {
+            add_task_to_index(task_set, i, task_set->task_list[i].core);
+        }
+    }
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset}
+                task_set!=NULL
+
+    Purpose of the function: Reads the virtual deadline factor of each task from ../input_deadlines.txt (written by DPS with the allocation), as lines of
+                             "task_number factor". If the file does not exist, the tasks use the x-factor of their cores.
+
+    Postconditions:
+        Output: {void}
+        Result: The deadline_factor of each task listed in the file is set. The lines which match no task of the taskset, or which cannot be read, are reported.
+*/
+void load_deadline_factors(task_set_struct *task_set)
+{
+    int i, task_number, num_line = 0;
+    double factor;
+    FILE *deadlines_file = fopen("../input_deadlines.txt", "r");
+
+    if (deadlines_file == NULL)
+        return;
+
+    while (fscanf(deadlines_file, "%d%lf", &task_number, &factor) == 2)
+    {
+        num_line++;
+        for (i = 0; i < task_set->total_tasks; i++)
+        {
+            if (task_set->task_list[i].task_number == task_number)
+            {
+                task_set->task_list[i].deadline_factor = factor;
+                break;
+            }
+        }
+
+        if (i == task_set->total_tasks)
+            printf("WARNING: Line %d of ../input_deadlines.txt: no task %d in the taskset, its deadline factor is ignored\n", num_line, task_number);
+    }
+
+    if (!feof(deadlines_file))
+        printf("WARNING: Line %d of ../input_deadlines.txt cannot be read, the next deadline factors are ignored\n", num_line + 1);
+
+    fclose(deadlines_file);
+    return;
+}
+
+/*
+    Function to free the task index of every core.
+*/
+void free_task_index(task_set_struct *task_set)
+{
+    int num_core, crit_level;
+
+    if (task_set->core_index == NULL)
+        return;
+
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            free(task_set->core_index[num_core].task_list[crit_level]);
+        }
+        free(task_set->core_index[num_core].task_list);
+        free(task_set->core_index[num_core].num_tasks);
+    }
+    free(task_set->core_index);
+    task_set->core_index = NULL;
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset}
+                task_set!=NULL
+
+    Purpose of the function: Creates a copy of the taskset which can be allocated independently of the original, e.g. by another thread.
+                             The task list is copied, but the WCET, util and exec_times arrays are shared with the original as they are not modified during allocation.
+                             The copy gets its own (empty) task index, no task table, its own cache of execution times drawn from the models and running sums of exec_times, and its own reader of the traces.
+
+    Postconditions:
+        Output: {Pointer to the copy of the taskset}
+*/
+task_set_struct *copy_task_set(task_set_struct *task_set)
+{
+    task_set_struct *copy = malloc(sizeof(task_set_struct));
+    int i;
+
+    copy->total_tasks = task_set->total_tasks;
+    copy->task_list = malloc(sizeof(task) * task_set->total_tasks);
+    memcpy(copy->task_list, task_set->task_list, sizeof(task) * task_set->total_tasks);
+    for (i = 0; i < copy->total_tasks; i++)
+    {
+        copy->task_list[i].exec_cache = NULL;
+        copy->task_list[i].exec_prefix = NULL;
+    }
+    copy_traces(copy);
+    copy->core_table = NULL;
+    initialize_task_index(copy);
+
+    return copy;
+}
+
+/*
+    Function to free a copy of the taskset created by copy_task_set. The shared arrays of the tasks are not freed, the cache and running sums of execution times and the readers of the traces are.
+*/
+void free_task_set_copy(task_set_struct *task_set)
+{
+    int i;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        free(task_set->task_list[i].exec_cache);
+        free(task_set->task_list[i].exec_prefix);
+        free_trace(task_set->task_list[i].trace);
+    }
+    free_task_table(task_set);
+    free_task_index(task_set);
+    free(task_set->task_list);
+    free(task_set);
+    return;
+}
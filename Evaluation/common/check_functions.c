@@ -1,20 +1,18 @@
 #include "functions.h"
 
-void find_total_utilisation(int total_tasks, task *tasks_list, double total_utilisation[][MAX_CRITICALITY_LEVELS], int core_no)
+void find_total_utilisation(task_set_struct *task_set, double total_utilisation[][MAX_CRITICALITY_LEVELS], int core_no)
 {
     int i, l, k;
+    task_index_struct *index = &(task_set->core_index[core_no]);
 
     for (l = 0; l < MAX_CRITICALITY_LEVELS; l++)
     {
         for (k = 0; k < MAX_CRITICALITY_LEVELS; k++)
         {
             total_utilisation[l][k] = 0;
-            for (i = 0; i < total_tasks; i++)
+            for (i = 0; i < index->num_tasks[l]; i++)
             {
-                if (tasks_list[i].criticality_lvl == l && tasks_list[i].core == core_no)
-                {
-                    total_utilisation[l][k] += tasks_list[i].util[k];
-                }
+                total_utilisation[l][k] += task_set->task_list[index->task_list[l][i]].util[k];
             }
         }
     }
@@ -22,9 +20,86 @@ void find_total_utilisation(int total_tasks, task *tasks_list, double total_util
     return;
 }
 
+/*
+    Preconditions:
+        Input: {pointer to core, pointer to the task being added}
+                core!=NULL
+                new_task!=NULL
+
+    Purpose of the function: Adds the utilisation of the task to the utilisation matrix of the core. The matrix is kept up to date during allocation,
+                             so that the schedulability check of a core does not scan the task list.
+
+    Postconditions:
+        Output: {void}
+*/
+void add_task_utilisation(core_struct *core, task *new_task)
+{
+    int k;
+    double *row = &(core->total_utilisation[new_task->criticality_lvl * MAX_CRITICALITY_LEVELS]);
+
+    for (k = 0; k < MAX_CRITICALITY_LEVELS; k++)
+    {
+        row[k] += new_task->util[k];
+    }
+    return;
+}
+
+/*
+    Function to remove the utilisation of a task from the utilisation matrix of the core, when a tentative allocation is undone.
+*/
+void remove_task_utilisation(core_struct *core, task *old_task)
+{
+    int k;
+    double *row = &(core->total_utilisation[old_task->criticality_lvl * MAX_CRITICALITY_LEVELS]);
+
+    for (k = 0; k < MAX_CRITICALITY_LEVELS; k++)
+    {
+        row[k] -= old_task->util[k];
+    }
+    return;
+}
+
 /*
     Preconditions:  
-        Input: {pointer to taskset, file pointer to output file}
+        Input: {pointer to taskset, core number}
+
+    Purpose of the function: This function checks whether the sub-taskset allocated to the core is schedulable or not. The utilisation matrix is computed from the task index of the core.
+
+    Postconditions: 
+        Output: {x-factor of the core. If the core is not schedulable, x = 0}
+*/
+x_factor_struct check_schedulability(task_set_struct *task_set, int core_no)
+{
+    double total_utilisation[MAX_CRITICALITY_LEVELS][MAX_CRITICALITY_LEVELS];
+
+    find_total_utilisation(task_set, total_utilisation, core_no);
+    print_total_utilisation(total_utilisation);
+
+    return find_x_factor(total_utilisation);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to core}
+                core!=NULL
+
+    Purpose of the function: Same as check_schedulability, but uses the utilisation matrix maintained incrementally in the core. The check is O(L^2), independent of the number of tasks.
+
+    Postconditions:
+        Output: {x-factor of the core. If the core is not schedulable, x = 0}
+*/
+x_factor_struct check_core_schedulability(core_struct *core)
+{
+    double (*total_utilisation)[MAX_CRITICALITY_LEVELS] = (double (*)[MAX_CRITICALITY_LEVELS])core->total_utilisation;
+
+    print_total_utilisation(total_utilisation);
+
+    return find_x_factor(total_utilisation);
+}
+
+/*
+    Preconditions:  
+        Input: {utilisation matrix of the core}
 
     Purpose of the function: This function checks whether the taskset is schedulable or not. The taskset is schedulable if:
                             U[LOW][LOW] + U[HIGH][HIGH] <= 1 ====> This implies that taskset can be scheduled according to EDF only.
@@ -32,17 +107,12 @@ void find_total_utilisation(int total_tasks, task *tasks_list, double total_util
                             If the taskset is schedulable, then compute the virtual deadlines of all the tasks according to their criticality levels.
 
     Postconditions: 
-        Output: {if taskset is schedulable, return 1. Else return 0}
-        Result: The taskset is checked for schedulability and the virtual deadlines of all the tasks is calculated.
+        Output: {if taskset is schedulable, return the x-factor and the threshold level k. Else x = 0}
 */
-x_factor_struct check_schedulability(task_set_struct *task_set, int core_no)
+x_factor_struct find_x_factor(double total_utilisation[][MAX_CRITICALITY_LEVELS])
 {
     // fprintf(output_file, "\n--------------SCHEDULABILITY CHECKS------------\n");
 
-    double total_utilisation[MAX_CRITICALITY_LEVELS][MAX_CRITICALITY_LEVELS];
-    int total_tasks = task_set->total_tasks;
-    task *tasks_list = task_set->task_list;
-
     double x, check1;
     double check_utilisation = 0.0;
     int check_feasibility = 1;
@@ -53,8 +123,7 @@ x_factor_struct check_schedulability(task_set_struct *task_set, int core_no)
     double util_HI_LO = 0.0;
     x_factor_struct x_factor;
 
-    find_total_utilisation(total_tasks, tasks_list, total_utilisation, core_no);
-    print_total_utilisation(total_utilisation);
+    x_factor.tuned = 0;
 
     //Condition to be checked for feasible tasksets. The total utilisation at each criticality level should be less than 1.
     for (i = 0; i < MAX_CRITICALITY_LEVELS; i++)
@@ -137,4 +206,411 @@ x_factor_struct check_schedulability(task_set_struct *task_set, int core_no)
     //If no such k exists, then the taskset is not schedulable.
     x_factor.x = 0.00;
     return x_factor;
-}
\ No newline at end of file
+}
+/*
+    Function to find the demand bound function of the tasks of a core at time t, in the lowest criticality mode (mode = 0) or in the high criticality mode (mode = 1).
+    factors[i] is the virtual deadline factor of task i if its criticality level is > k.
+        Mode 0: The tasks with criticality level <= k execute their WCET at their own level with their deadline, the tasks with criticality level > k their WCET at level k
+                with the virtual deadline factors[i] * D.
+        Mode 1: Only the tasks with criticality level > k, with the carry-over jobs of the mode switch (Ekberg and Yi, 2014): full(t) - done(t), where full counts the WCETs
+                at the task's own level with deadlines D - factors[i] * D + m * T and done is the part of the WCET at level k that the carry-over job has surely executed.
+*/
+static double find_task_demand(task *curr_task, int k, double factor, double t, int mode)
+{
+    double C, C_lo, deadline, n, demand;
+    int level = curr_task->criticality_lvl;
+
+    if (mode == 0)
+    {
+        C = (level <= k) ? curr_task->WCET[level] : curr_task->WCET[k];
+        deadline = (level <= k) ? curr_task->relative_deadline : factor * curr_task->relative_deadline;
+        return (t >= deadline - 1e-9) ? (floor((t - deadline) / curr_task->period + 1e-9) + 1) * C : 0.00;
+    }
+
+    if (level <= k)
+        return 0.00;
+
+    C = curr_task->WCET[level];
+    C_lo = curr_task->WCET[k];
+    deadline = curr_task->relative_deadline - factor * curr_task->relative_deadline;
+    if (t < deadline - 1e-9)
+        return 0.00;
+
+    demand = (floor((t - deadline) / curr_task->period + 1e-9) + 1) * C;
+    n = fmod(t, curr_task->period);
+    if (n >= deadline && n < curr_task->relative_deadline)
+        demand -= max(0.00, C_lo - n + deadline);
+    return demand;
+}
+
+static double find_demand(task **tasks, int num_tasks, int k, double *factors, double t, int mode)
+{
+    double demand = 0.00;
+    int i;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        demand += find_task_demand(tasks[i], k, factors[i], t, mode);
+    }
+    return demand;
+}
+
+/*
+    Function to find the largest point smaller than t at which the demand bound function of the mode steps up (an absolute deadline in mode 0, a deadline of a full
+    job of the carry-over demand in mode 1). Returns -1 if there is none.
+*/
+static double find_previous_deadline(task **tasks, int num_tasks, int k, double *factors, double t, int mode)
+{
+    double previous = -1.00, deadline, point;
+    int i, level;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        level = tasks[i]->criticality_lvl;
+        if (mode == 1 && level <= k)
+            continue;
+
+        if (mode == 0)
+            deadline = (level <= k) ? tasks[i]->relative_deadline : factors[i] * tasks[i]->relative_deadline;
+        else
+            deadline = tasks[i]->relative_deadline - factors[i] * tasks[i]->relative_deadline;
+        if (deadline >= t - 1e-9)
+            continue;
+
+        point = deadline + (ceil((t - deadline) / tasks[i]->period) - 1) * tasks[i]->period;
+        //The division may round up when t is a step point of the task.
+        if (point >= t - 1e-9)
+            point -= tasks[i]->period;
+        previous = max(previous, point);
+    }
+
+    return previous;
+}
+
+/*
+    Preconditions:
+        Input: {tasks of the core, number of tasks, threshold level k, virtual deadline factors, mode (0 or 1)}
+
+    Purpose of the function: Exact processor demand test of the mode with Quick Processor-demand Analysis (Zhang and Burns, 2009). The demand bound function is only
+                             checked at the points visited by QPA, from the largest step point below the bound L down to the smallest deadline:
+                                t = h(t) if h(t) < t, else the previous step point; the mode is schedulable if h(t) <= d_min at the end.
+                             L is the smaller of the bound of Zhang and Burns (max(D, sum (T - D) * U / (1 - U))) and the synchronous busy period. The test stops at the first
+                             point with h(t) > t, and before QPA if the utilisation of the mode is greater than 1.
+
+    Postconditions:
+        Output: {The first point t found with h(t) > t, INT_MAX if the utilisation of the mode is greater than 1, or -1 if the mode is schedulable}
+*/
+static double find_demand_violation(task **tasks, int num_tasks, int k, double *factors, int mode)
+{
+    double utilisation = 0.00, slack_sum = 0.00, max_deadline = 0.00, min_deadline = INT_MAX, busy_period = 0.00, next;
+    double C, deadline, bound, t, demand;
+    int i, level, iteration;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        level = tasks[i]->criticality_lvl;
+        if (mode == 1 && level <= k)
+            continue;
+
+        if (mode == 0)
+        {
+            C = (level <= k) ? tasks[i]->WCET[level] : tasks[i]->WCET[k];
+            deadline = (level <= k) ? tasks[i]->relative_deadline : factors[i] * tasks[i]->relative_deadline;
+        }
+        else
+        {
+            C = tasks[i]->WCET[level];
+            deadline = tasks[i]->relative_deadline - factors[i] * tasks[i]->relative_deadline;
+        }
+
+        utilisation += C / tasks[i]->period;
+        slack_sum += (tasks[i]->period - deadline) * C / tasks[i]->period;
+        max_deadline = max(max_deadline, deadline);
+        min_deadline = min(min_deadline, deadline);
+        busy_period += C;
+    }
+
+    if (busy_period == 0.00)
+        return -1.00;
+    if (utilisation > 1.00 + 1e-9)
+        return INT_MAX;
+
+    //Synchronous busy period, w = sum(ceil(w / T) * C). It is unbounded when the utilisation is 1.
+    for (iteration = 0; iteration < 1000; iteration++)
+    {
+        next = 0.00;
+        for (i = 0; i < num_tasks; i++)
+        {
+            level = tasks[i]->criticality_lvl;
+            if (mode == 1 && level <= k)
+                continue;
+            C = (mode == 1 || level <= k) ? tasks[i]->WCET[level] : tasks[i]->WCET[k];
+            next += ceil(busy_period / tasks[i]->period - 1e-9) * C;
+        }
+        if (next <= busy_period + 1e-9)
+            break;
+        busy_period = next;
+    }
+
+    bound = busy_period;
+    if (utilisation < 1.00 - 1e-9)
+        bound = min(bound, max(max_deadline, slack_sum / (1.00 - utilisation)));
+
+    t = find_previous_deadline(tasks, num_tasks, k, factors, bound + 1e-6, mode);
+    while (t >= 0.00)
+    {
+        demand = find_demand(tasks, num_tasks, k, factors, t, mode);
+        if (demand > t + 1e-9)
+            return t;
+        if (demand <= min_deadline + 1e-9)
+            return -1.00;
+
+        if (demand < t - 1e-9)
+            t = demand;
+        else
+            t = find_previous_deadline(tasks, num_tasks, k, factors, t, mode);
+    }
+
+    return -1.00;
+}
+
+/*
+    Preconditions:
+        Input: {tasks of the core, number of tasks, threshold level k, virtual deadline factors (the starting point)}
+                The LO mode is schedulable with the starting factors.
+
+    Purpose of the function: Tunes the virtual deadline factor of each task with criticality level > k (Ekberg and Yi, 2014). While the HI mode has a point t with
+                             h(t) > t, the virtual deadline of one task is shortened by DEADLINE_FACTOR_STEP of its deadline: the task whose shorter virtual deadline
+                             decreases the HI mode demand at t the most, among those for which the LO mode stays schedulable. Virtual deadlines only get shorter, so
+                             the tuning ends after at most 1 / DEADLINE_FACTOR_STEP steps per task.
+
+    Postconditions:
+        Output: {1 if both modes are schedulable with the tuned factors, else 0}
+        Result: factors contains the tuned factors.
+*/
+static int tune_factors(task **tasks, int num_tasks, int k, double *factors)
+{
+    double t, decrease, old_factor, *gain = malloc(sizeof(double) * num_tasks);
+    int i, best, found;
+
+    while ((t = find_demand_violation(tasks, num_tasks, k, factors, 1)) >= 0.00)
+    {
+        //The utilisation of the HI mode does not depend on the virtual deadlines.
+        if (t == INT_MAX)
+            break;
+
+        for (i = 0; i < num_tasks; i++)
+        {
+            gain[i] = -1.00;
+            if (tasks[i]->criticality_lvl <= k || factors[i] - DEADLINE_FACTOR_STEP < DEADLINE_FACTOR_STEP / 2)
+                continue;
+            decrease = find_task_demand(tasks[i], k, factors[i], t, 1);
+            decrease -= find_task_demand(tasks[i], k, factors[i] - DEADLINE_FACTOR_STEP, t, 1);
+            gain[i] = decrease;
+        }
+
+        //Shorten the virtual deadline with the largest gain which keeps the LO mode schedulable.
+        found = 0;
+        while (!found)
+        {
+            for (i = 0, best = -1; i < num_tasks; i++)
+            {
+                if (gain[i] >= 0.00 && (best == -1 || gain[i] > gain[best]))
+                    best = i;
+            }
+            if (best == -1)
+                break;
+
+            old_factor = factors[best];
+            factors[best] -= DEADLINE_FACTOR_STEP;
+            if (find_demand_violation(tasks, num_tasks, k, factors, 0) < 0.00)
+                found = 1;
+            else
+            {
+                factors[best] = old_factor;
+                gain[best] = -1.00;
+            }
+        }
+
+        if (!found)
+        {
+            free(gain);
+            return 0;
+        }
+    }
+
+    free(gain);
+    return (t < 0.00);
+}
+
+/*
+    Function to find the tasks allocated to a core (from its task index). Returns the number of tasks; tasks is allocated and must be freed.
+*/
+static int find_core_tasks(task_set_struct *task_set, int core_no, task ***tasks)
+{
+    task_index_struct *index = &(task_set->core_index[core_no]);
+    int crit_level, i, num_tasks = 0;
+
+    for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+    {
+        num_tasks += index->num_tasks[crit_level];
+    }
+    *tasks = malloc(sizeof(task *) * max_int(1, num_tasks));
+    for (crit_level = 0, num_tasks = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+    {
+        for (i = 0; i < index->num_tasks[crit_level]; i++)
+        {
+            (*tasks)[num_tasks++] = &(task_set->task_list[index->task_list[crit_level][i]]);
+        }
+    }
+    return num_tasks;
+}
+
+/*
+    Preconditions:
+        Input: {tasks of the core, number of tasks, threshold level k, array for the factors}
+
+    Purpose of the function: Finds per-task virtual deadline factors for threshold level k with tune_factors. The tuning starts from the factors stored in the tasks
+                             by the previous allocation to the core (1 for a new task), so adding a task only re-tunes from where the core was. If the LO mode
+                             is not schedulable with these factors, the tuning starts again from 1 for every task.
+
+    Postconditions:
+        Output: {1 if the core is schedulable with the tuned factors, else 0}
+*/
+static int find_tuned_factors(task **tasks, int num_tasks, int k, double *factors)
+{
+    int i;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        factors[i] = (tasks[i]->criticality_lvl > k && tasks[i]->deadline_factor > 0.00) ? tasks[i]->deadline_factor : 1.00;
+    }
+    if (find_demand_violation(tasks, num_tasks, k, factors, 0) >= 0.00)
+    {
+        for (i = 0; i < num_tasks; i++)
+            factors[i] = 1.00;
+        if (find_demand_violation(tasks, num_tasks, k, factors, 0) >= 0.00)
+            return 0;
+    }
+
+    return tune_factors(tasks, num_tasks, k, factors);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to core, core number}
+                The task index of the core and the utilisation matrix of the core contain the tasks allocated to it.
+
+    Purpose of the function: Exact demand-based EDF-VD test of the core. If the utilisation-based test (find_x_factor) accepts the core, its x-factor and threshold level are used.
+                             Otherwise, if demand_allocation is set, for each threshold level k (the tasks with criticality level > k are HI):
+                                1. The smallest x for which the LO mode passes the processor demand test is found by bisection (the LO mode demand decreases and the
+                                   HI mode demand increases with x), and the core is accepted if the HI mode with the carry-over jobs also passes at that x.
+                                2. Else, the virtual deadline of each HI task is tuned separately (find_tuned_factors). The tasks are not modified; the factors are
+                                   stored by set_deadline_factors when the core is chosen.
+                             Both modes are checked with QPA (find_demand_violation).
+
+    Postconditions:
+        Output: {x-factor and threshold level of the core (with tuned = 1 if per-task factors are needed, x is then the largest factor). If the core is not schedulable, x = 0}
+*/
+x_factor_struct check_demand_schedulability(task_set_struct *task_set, core_struct *core, int core_no)
+{
+    task_index_struct *index = &(task_set->core_index[core_no]);
+    x_factor_struct x_factor = check_core_schedulability(core);
+    int i, num_tasks, k, num_hi;
+    double low, high, mid, *factors;
+    task **tasks;
+
+    if (x_factor.x != 0.00 || !demand_allocation)
+        return x_factor;
+
+    num_tasks = find_core_tasks(task_set, core_no, &tasks);
+    factors = malloc(sizeof(double) * max_int(1, num_tasks));
+
+    x_factor.x = 0.00;
+    x_factor.tuned = 0;
+    for (k = 0, num_hi = num_tasks; k < MAX_CRITICALITY_LEVELS - 1; k++)
+    {
+        num_hi -= index->num_tasks[k];
+        if (num_hi == 0)
+            break;
+
+        for (i = 0; i < num_tasks; i++)
+            factors[i] = 1.00;
+        if (find_demand_violation(tasks, num_tasks, k, factors, 0) >= 0.00)
+            continue;
+
+        low = 0.00;
+        high = 1.00;
+        for (i = 0; i < 20; i++)
+        {
+            mid = (low + high) / 2;
+            for (int j = 0; j < num_tasks; j++)
+                factors[j] = mid;
+            if (find_demand_violation(tasks, num_tasks, k, factors, 0) < 0.00)
+                high = mid;
+            else
+                low = mid;
+        }
+
+        for (i = 0; i < num_tasks; i++)
+            factors[i] = high;
+        if (find_demand_violation(tasks, num_tasks, k, factors, 1) < 0.00)
+        {
+            x_factor.x = high;
+            x_factor.k = k;
+            fprintf(output_file, "Demand test: crit_level: %d, x: %.5lf\n", k, high);
+            break;
+        }
+
+        if (find_tuned_factors(tasks, num_tasks, k, factors))
+        {
+            for (i = 0; i < num_tasks; i++)
+            {
+                if (tasks[i]->criticality_lvl > k)
+                    x_factor.x = max(x_factor.x, factors[i]);
+            }
+            x_factor.k = k;
+            x_factor.tuned = 1;
+            fprintf(output_file, "Demand test: crit_level: %d, tuned virtual deadlines\n", k);
+            break;
+        }
+    }
+
+    free(factors);
+    free(tasks);
+    return x_factor;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, core number, x-factor of the core returned by check_demand_schedulability}
+                The core has been chosen for the task being allocated, and its task index contains the task.
+
+    Purpose of the function: Stores the virtual deadline factor of each task of the core. If the core needs per-task factors, they are tuned again from the factors
+                             of the previous allocation (the same tuning as in check_demand_schedulability); else the factors are cleared and the x-factor of the core is used.
+
+    Postconditions:
+        Output: {void}
+        Result: The deadline_factor of each task of the core is set (0 to use the x-factor of the core).
+*/
+void set_deadline_factors(task_set_struct *task_set, int core_no, x_factor_struct x_factor)
+{
+    task **tasks;
+    double *factors;
+    int i, num_tasks = find_core_tasks(task_set, core_no, &tasks);
+
+    factors = malloc(sizeof(double) * max_int(1, num_tasks));
+    if (x_factor.tuned && find_tuned_factors(tasks, num_tasks, x_factor.k, factors))
+    {
+        for (i = 0; i < num_tasks; i++)
+            tasks[i]->deadline_factor = (tasks[i]->criticality_lvl > x_factor.k) ? factors[i] : 0.00;
+    }
+    else
+    {
+        for (i = 0; i < num_tasks; i++)
+            tasks[i]->deadline_factor = 0.00;
+    }
+
+    free(factors);
+    free(tasks);
+}
@@ -29,14 +29,155 @@
 #define INT_MAX 2147483647
 
 #define SHUTDOWN_THRESHOLD 200
+//The number of cores can be changed at compile time, e.g. make CFLAG="-g -Wall -DNUM_CORES=16".
+#ifndef NUM_CORES
 #define NUM_CORES 4
+#endif
 
 #define FREQUENCY_LEVELS 5
 
+//Allocation modes
+#define DEFAULT_ALLOCATION 0
+#define PORTFOLIO_ALLOCATION 1
+#define OPTIMIZED_ALLOCATION 2
+#define MINIMUM_CORES_ALLOCATION 3
+#define PROBABILISTIC_ALLOCATION 4
+
+//Allocation heuristics
+#define FIRST_FIT 301
+#define BEST_FIT 302
+#define WORST_FIT 303
+#define MODE_SWITCH_FIT 304
+
+#define ORDER_SHUTDOWN 311
+#define ORDER_CRITICALITY 312
+#define ORDER_UTILISATION 313
+
+//Period sets of the taskset generator
+#define HARMONIC_PERIODS 401
+#define NON_HARMONIC_PERIODS 402
+#define MAX_GENERATOR_LEVELS 8
+
+//Execution time models
+#define EXEC_UNIFORM 501
+#define EXEC_NORMAL 502
+#define EXEC_WEIBULL 503
+#define EXEC_GUMBEL 504
+#define EXEC_EMPIRICAL 505
+#define EXEC_BATCH_SIZE 64
+//The smallest execution time of a job drawn from a model.
+#define MIN_EXECUTION_TIME 0.01
+#define TRACE_BUFFER_SIZE 1024
+
+//Probabilistic analysis
+#define PMF_MODEL_POINTS 256
+#define MAX_PMF_BINS 4096
+#define FFT_THRESHOLD 64
+
+//Per-task virtual deadline tuning: the virtual deadline factor of a task is shortened by this step.
+#define DEADLINE_FACTOR_STEP 0.02
+
+//Windowed simulation: the metrics are checked after each window, from CONVERGENCE_MIN_WINDOWS windows on.
+#define NUM_METRICS 4
+#define CONVERGENCE_MIN_WINDOWS 5
+#define CONVERGENCE_CONFIDENCE 0.95
+
+//Knapsack readmission of discarded jobs: the execution times are counted in units of 1/KNAPSACK_BINS of the total execution time of the candidates.
+#define KNAPSACK_BINS 512
+
 #define DPS 1001
 #define EDF_VD 1002
 #define EDF_VD_DJ 1003
 #define EDF 1004
+#define NUM_ALGORITHMS 4
+
+/*
+    ADT for the state of a random number generator (SplitMix64). A generator can be split into independent streams, e.g. one per taskset,
+    so that a generated taskset only depends on the seed and its index and not on the thread or the order in which it is generated.
+*/
+typedef struct rng_struct
+{
+    unsigned long long state;
+} rng_struct;
+
+/*
+    ADT for the execution time model of a task. The execution times are relative to the WCET of the task at the lowest criticality level.
+        type: EXEC_UNIFORM (param[0], param[1]: minimum and maximum), EXEC_NORMAL (param[0], param[1]: mean and standard deviation),
+              EXEC_WEIBULL (param[0], param[1]: shape and scale), EXEC_GUMBEL (param[0], param[1]: location and scale)
+              or EXEC_EMPIRICAL (values, cdf, num_bins: the values of the histogram in increasing order and their cumulative probability).
+*/
+typedef struct exec_model_struct
+{
+    int type;
+    double param[2];
+    double *values;
+    double *cdf;
+    int num_bins;
+} exec_model_struct;
+
+/*
+    ADT for the shared reader of an interleaved trace. The file is read once for all the tasks: the lines of each task are appended to the buffer of its trace.
+        path, file: The trace and the open file, opened at the first access.
+        num_tasks: The number of tasks of the taskset, the size of traces.
+        num_users: The number of traces using the reader. The reader is freed with its last trace.
+        traces: The trace of each task number, NULL for the tasks without one.
+*/
+typedef struct trace_reader_struct
+{
+    char *path;
+    FILE *file;
+    int num_tasks;
+    int num_users;
+    struct trace_struct **traces;
+} trace_reader_struct;
+
+/*
+    ADT for the replay of the measured execution times of a task. The trace is read through a read-ahead buffer of TRACE_BUFFER_SIZE jobs, so it is never resident as a whole.
+        path: The trace file. It contains the execution times of the jobs of the task, or lines "task_number execution_time" of all the tasks (interleaved).
+        task_filter: The task number to read from an interleaved trace, -1 for the trace of a single task.
+        reader: The shared reader of an interleaved trace, NULL for the trace of a single task.
+        file: The open trace of a single task, opened at the first access.
+        buffer, buffer_size: The execution times of the jobs first_job to first_job + num_buffered - 1, and the allocated size of the buffer. The buffer of an
+                             interleaved trace grows when the reader fills it with the lines of the task read for the other tasks.
+        length: The number of jobs of the trace of a single task, once its end has been reached (0 before). The trace is replayed from the start after its end.
+        num_read: The number of jobs of the task read since the reader was last at the start of an interleaved trace.
+*/
+typedef struct trace_struct
+{
+    char *path;
+    int task_filter;
+    trace_reader_struct *reader;
+    FILE *file;
+    double *buffer;
+    int buffer_size;
+    int first_job;
+    int num_buffered;
+    int length;
+    int num_read;
+} trace_struct;
+
+/*
+    ADT for the distribution of the execution time of a job (probability mass function).
+        num_points: The number of values.
+        value, prob: The values, distinct and in increasing order, and their probabilities.
+*/
+typedef struct pmf_struct
+{
+    int num_points;
+    double *value;
+    double *prob;
+} pmf_struct;
+
+/*
+    ADT for the result of the probabilistic analysis of a core over a horizon.
+        deadline_miss: The probability that the demand of the jobs with deadline <= t exceeds t, for some deadline t.
+        mode_switch: The probability that a job overruns its WCET at the lowest criticality level, i.e., that the core leaves the lowest criticality mode.
+*/
+typedef struct probability_struct
+{
+    double deadline_miss;
+    double mode_switch;
+} probability_struct;
 
 /*
     ADT for a task. The parameters in the task are:
@@ -48,6 +189,14 @@
         virtual_deadline: The virtual deadline calculated for the task. 
         job_number: The number of jobs released by the task.
         util: Utilisation of the task at each criticality level.
+        table_index: The position of the task in the task table of its core.
+        exec_model: The execution time model of the task, or NULL. If exec_times is NULL, the execution times are drawn from the model in batches of
+                    EXEC_BATCH_SIZE jobs when the jobs arrive; batch b uses the stream b of exec_rng, so the times do not depend on the order of generation.
+        exec_cache, exec_batch: The execution times of the last batch drawn and its number.
+        exec_prefix, num_prefix, prefix_size: The running sums of exec_times (exec_prefix[j] is the total execution time of the jobs 0 to j - 1), for the jobs 0 to
+                    num_prefix - 1, and the size of the array. Extended when needed by find_jobs_execution_time.
+        trace: The trace from which the execution times are replayed, or NULL.
+        deadline_factor: The virtual deadline factor of the task found by the per-task tuning of its core, or 0 if it uses the x-factor of its core.
 */
 typedef struct task
 {
@@ -63,16 +212,66 @@ typedef struct task
     double *util;
     double *exec_times;
     int shutdown;
+    int table_index;
+    exec_model_struct *exec_model;
+    rng_struct exec_rng;
+    double *exec_cache;
+    int exec_batch;
+    double *exec_prefix;
+    int num_prefix;
+    int prefix_size;
+    trace_struct *trace;
+    double deadline_factor;
 } task;
 
+/*
+    ADT for the task index of a core.
+        num_tasks[l]: The number of tasks of criticality level l allocated to the core.
+        task_list[l]: The indices (in the task list) of the tasks of criticality level l allocated to the core, in increasing order.
+*/
+typedef struct task_index_struct
+{
+    int *num_tasks;
+    int **task_list;
+} task_index_struct;
+
+/*
+    ADT for the task table of a core. It stores the fields of the tasks allocated to the core which are used in the per-task loops of the scheduler
+    as a structure of arrays, so that they can be processed with vector instructions.
+        num_tasks: The number of tasks allocated to the core.
+        level_start[l]: The position of the first task of criticality level l. The tasks are stored in increasing order of criticality level,
+                        so the tasks with criticality level >= l are in [level_start[l], num_tasks).
+        task_number: The index of the task in the task list.
+        phase, period, virtual_deadline: Same as in the task.
+        job_number: The number of jobs released by the task (stored as double for the vector kernels).
+        WCET: The worst case execution time of the task at its own criticality level.
+        util: Utilisation of the task at each criticality level (MAX_CRITICALITY_LEVELS values per task).
+*/
+typedef struct task_table_struct
+{
+    int num_tasks;
+    int *level_start;
+    int *task_number;
+    double *phase;
+    double *period;
+    double *job_number;
+    double *virtual_deadline;
+    double *WCET;
+    double *util;
+} task_table_struct;
+
 /*
     ADT for task list. 
         It contains the total tasks and the pointer to the tasks list array.
+        core_index: The task index of each core, filled during allocation.
+        core_table: The task table of each core, built after allocation.
 */
 typedef struct task_set_struct
 {
     int total_tasks;
     task *task_list;
+    task_index_struct *core_index;
+    task_table_struct *core_table;
 } task_set_struct;
 
 /*
@@ -84,8 +283,13 @@ typedef struct task_set_struct
         execution_time: The actual execution time of the job.
         actual_execution_time: The time for which job has executed.
         completion_time: The time at which the job will finish execution.
-        WCET_counter: A counter to check whether the job exceeds the worst case execution time.
-        absolute_deadline: The deadline of the job.
+        WCET_counter: A counter to check whether the job exceeds the worst case execution time. It is the budget at the criticality level budget_level;
+                      in a ready queue the budget follows the level of the queue (mode_level) and is brought up to date when the job is scheduled (update_job_budget).
+        job_task: The task of the job. The deadline of the job is not stored: it is the release time plus the current virtual deadline of the task (find_job_deadline),
+                  which is reset when the core of the task passes its threshold level, so the deadlines of the queued jobs need not be rewritten.
+        criticality_lvl: The criticality level of the task, i.e., the list of the job queue in which the job is kept.
+        queue_order: The order of insertion of the job in its ready queue, which breaks the ties between the deadlines of different levels.
+        discarded: 1 if the job was discarded (its execution time is counted in the discarded work of its core), else 0.
         next: A link to the next job in the array.
 
 */
@@ -93,13 +297,17 @@ struct job
 {
     double release_time;
     double execution_time;
-    double absolute_deadline;
     double scheduled_time;
     double rem_exec_time;
     double completion_time;
     double WCET_counter;
+    int budget_level;
     int job_number;
     int task_number;
+    task *job_task;
+    int criticality_lvl;
+    int queue_order;
+    int discarded;
     struct job *next;
 };
 
@@ -108,11 +316,20 @@ typedef struct job job;
 /*
     ADT for job queue. 
         It contains the total number of jobs in ready queue and pointer to the ready queue.
+        level_head[l]: The jobs of criticality level l, sorted according to the deadlines (MAX_CRITICALITY_LEVELS lists). The head of the ready queue is the earliest
+                       of the heads of the lists (find_earliest_job), and the discarded queue is the lists from the highest level to the lowest.
+        next_order: The queue_order of the next job inserted in the ready queue.
+        mode_level: The criticality level at which the budgets of the jobs in the ready queue are counted. Raised on a criticality change without visiting the jobs.
+        ready_jobs: The running numbers of the ready jobs of the processor (processor->ready_jobs), shared by its ready queues, or NULL.
+                    Kept up to date by the insertions and removals of the ready queues (count_ready_job).
 */
 typedef struct job_queue_struct
 {
     int num_jobs;
-    job *job_list_head;
+    job **level_head;
+    int next_order;
+    int mode_level;
+    int *ready_jobs;
 } job_queue_struct;
 
 /*
@@ -127,10 +344,14 @@ typedef struct job_queue_struct
         next_invocation_time: The countdown timer for core. The core will wakeup after timer expires.
         x_factor: The factor to be used while calculating virtual deadlines.
         threshold_crit_lvl: The threshold level aboe which all tasks are considered as HI criticality and below which all tasks are considered as LO criticality.
+        crit_level: The current criticality level of the core. All the cores change their level together, unless per_core_mode is set.
+        mode_switch_time: The time at which the core left the lowest criticality level.
         rem_util: The remaining utilisation of core. This is needed to check whether additional tasks can be allocated to this core.
         completed_scheduling: Flag to indicate whether this core has completed its hyperperiod.
         is_shutdown: SHUTDOWN or NON-SHUTDOWN core.
         num_tasks_allocated: The number of tasks allocated to that core.
+        total_utilisation: The utilisation matrix of the tasks allocated to the core (MAX_CRITICALITY_LEVELS x MAX_CRITICALITY_LEVELS, row major).
+                           total_utilisation[l * MAX_CRITICALITY_LEVELS + k] is the utilisation at level k of the tasks with criticality level l. Updated incrementally during allocation.
 */
 typedef struct core_struct
 {
@@ -145,18 +366,61 @@ typedef struct core_struct
     double frequency;
     int state; //ACTIVE or SHUTDOWN
     double *rem_util;
+    double *total_utilisation;
 
     double x_factor;
     int threshold_crit_lvl;
     int is_shutdown;
+    int crit_level;
+    double mode_switch_time;
 
 } core_struct;
 
+/*
+    ADT for a discarded job considered by the knapsack readmission (select_discarded_jobs).
+        discarded_job: The discarded job.
+        position: The position of the job in the discarded queue (the lists of the levels from the highest, each in its order).
+        deadline: The deadline of the job.
+        exec_time, slack: The remaining WCET of the job and the maximum slack of the core before its deadline.
+        weight: The remaining WCET of the job, in units of the knapsack (rounded up).
+        capacity: The maximum slack of the core before the deadline of the job, in units of the knapsack (rounded down).
+        value: The value of readmitting the job.
+*/
+typedef struct knapsack_item_struct
+{
+    job *discarded_job;
+    int position;
+    double deadline;
+    double exec_time;
+    double slack;
+    int weight;
+    int capacity;
+    double value;
+} knapsack_item_struct;
+
+/*
+    ADT for the slack index of the processor, a summary of the demand curve of each core used to place the discarded jobs on the other cores.
+        committed_work[c]: The remaining WCET of the jobs in the ready queue of core c at index_time[c].
+        index_time[c]: The time at which the entry of core c was last updated (the last decision point of the core).
+        utilisation[c]: The utilisation of the tasks of core c at the criticality level of the core.
+    The demand of core c over [t, d] is summarised as max(0, committed_work[c] - (t - index_time[c])) + utilisation[c] * (d - t), and the slack estimated from it.
+*/
+typedef struct slack_index_struct
+{
+    double *committed_work;
+    double *index_time;
+    double *utilisation;
+} slack_index_struct;
+
 /*
     ADT for the processor. 
         total_cores: Total number of cores in the processor.
-        crit_level: The current criticality level of the processor.
+        crit_level: The current criticality level of the processor, the highest criticality level of the cores.
         cores: List of core structs.
+        slack_index: The slack index of the cores, if the discarded jobs are migrated (discarded_migration), else NULL.
+        ready_jobs: The number of jobs of each criticality level of the tasks of each core in the ready queues of all the cores (total_cores x MAX_CRITICALITY_LEVELS,
+                    row major), if the criticality level returns (mode_return), else NULL. The jobs readmitted on another core are counted for the core of their task.
+                    The highest level of the ready jobs of the tasks of a core is found from it without walking the ready queues.
 */
 
 typedef struct processor_struct
@@ -164,6 +428,8 @@ typedef struct processor_struct
     int total_cores;
     int crit_level;
     core_struct *cores;
+    slack_index_struct *slack_index;
+    int *ready_jobs;
 } processor_struct;
 
 /*
@@ -177,12 +443,50 @@ typedef struct decision_struct
     int decision_point;
 } decision_struct;
 
+/*
+    ADT for the result of a schedulability test of a core.
+        x: The x-factor of the core, 0 if it is not schedulable.
+        k: The threshold criticality level.
+        tuned: 1 if the tasks of the core need their own virtual deadline factors (the deadline_factor of the tasks), x is then the largest of them.
+*/
 typedef struct x_factor_struct
 {
     double x;
     int k;
+    int tuned;
 } x_factor_struct;
  
+/*
+    ADT for the convergence check of a windowed simulation (batch means). The metrics are the active, idle and shutdown fractions of the time of the cores
+    and the discarded job ratio (executed / available execution time of discarded jobs).
+        next_window: The end of the current window.
+        num_windows: The number of windows completed.
+        last[]: The totals (active, idle, shutdown, discarded executed, discarded available) of all the cores at the end of the previous window.
+        sum_x[], sum_y[], sum_xx[], sum_xy[], sum_yy[]: Sums over the windows of the numerator x and denominator y of each metric in the window, and of their products.
+        confidence: The smallest, over the metrics, confidence that the estimate of the metric is within convergence_tolerance of its mean.
+*/
+typedef struct convergence_struct
+{
+    double next_window;
+    int num_windows;
+    double last[NUM_METRICS + 1];
+    double sum_x[NUM_METRICS];
+    double sum_y[NUM_METRICS];
+    double sum_xx[NUM_METRICS];
+    double sum_xy[NUM_METRICS];
+    double sum_yy[NUM_METRICS];
+    double confidence;
+} convergence_struct;
+
+/*
+    ADT for the statistics of a simulation. The totals are kept for each core, except:
+        peak_discarded_jobs: The largest number of jobs in the discarded queue.
+        total_evicted_jobs: The number of jobs evicted from the discarded queue because it was full (discarded_capacity).
+    The mode statistics of each core are:
+        total_mode_switches: The number of times the criticality level of the core was raised.
+        total_mode_returns: The number of times the criticality level of the core was lowered (mode_return).
+        total_raised_time: The time spent by the core above the lowest criticality level.
+*/
 typedef struct stats_struct
 {
     double *total_shutdown_time;
@@ -196,8 +500,105 @@ typedef struct stats_struct
     int *total_discarded_jobs;
     double *total_discarded_jobs_executed;
     double *total_discarded_jobs_available;
+    int peak_discarded_jobs;
+    int total_evicted_jobs;
+    int *total_mode_switches;
+    int *total_mode_returns;
+    double *total_raised_time;
 } stats_struct;
 
+/*
+    ADT for an allocation heuristic of the portfolio.
+        fit: FIRST_FIT, BEST_FIT, WORST_FIT or MODE_SWITCH_FIT (the core with the lowest mode switch probability). The core chosen for a task among the cores on which it is schedulable.
+        order: ORDER_SHUTDOWN (exceptional, non-shutdown and then shutdown tasks), ORDER_CRITICALITY (criticality level, then utilisation, decreasing)
+               or ORDER_UTILISATION (utilisation, decreasing). The order in which tasks are allocated.
+        max_util: Maximum utilisation per criticality level allowed for each core (MAX_UTIL).
+*/
+typedef struct heuristic_struct
+{
+    int fit;
+    int order;
+    double max_util;
+} heuristic_struct;
+
+/*
+    ADT for the result of an allocation.
+        core: The core of each task in the task list. -1 if the task could not be allocated.
+        x_factor, threshold_crit_lvl, is_shutdown: Per core values, as in the core struct.
+        feasible: 1 if all the tasks were allocated.
+        energy: Analytic estimate of the energy consumed per unit time by the allocation.
+        shutdown: Analytic estimate of the fraction of time for which the cores are shutdown.
+        mode_switch: The sum over the cores of the probability that the core leaves the lowest criticality mode in the super hyperperiod.
+        deadline_factor: The virtual deadline factor of each task in the task list (0 if it uses the x-factor of its core).
+*/
+typedef struct allocation_struct
+{
+    int *core;
+    double *x_factor;
+    int *threshold_crit_lvl;
+    int *is_shutdown;
+    int feasible;
+    double energy;
+    double shutdown;
+    double mode_switch;
+    double *deadline_factor;
+} allocation_struct;
+
+/*
+    ADT for the result of the simulation of an allocation with one algorithm (run_all_algorithms).
+        completed: 1 if all the cores reached the end of the simulation, 0 if a deadline was missed.
+        active_time, idle_time, shutdown_time: Total times of all the cores.
+        discarded_exec, discarded_avail: Total execution time of discarded jobs that were executed and that were available.
+*/
+typedef struct simulation_result_struct
+{
+    int completed;
+    double active_time;
+    double idle_time;
+    double shutdown_time;
+    double discarded_exec;
+    double discarded_avail;
+} simulation_result_struct;
+
+/*
+    ADT for the results of one utilisation level of the sweep, for each algorithm (in the order DPS, EDF-VD, EDF-VD-DJ, EDF).
+        utilisation: The normalized utilisation (total utilisation at the lowest criticality level / NUM_CORES) of the generated tasksets.
+        num_tasksets: The number of tasksets generated.
+        accepted: The number of tasksets allocated and scheduled without a deadline miss.
+        active_time, idle_time, shutdown_time: Total times of all the cores over the accepted tasksets.
+        discarded_exec, discarded_avail: Total execution time of discarded jobs that were executed and that were available, over the accepted tasksets.
+*/
+typedef struct sweep_point_struct
+{
+    double utilisation;
+    int num_tasksets;
+    int accepted[NUM_ALGORITHMS];
+    double active_time[NUM_ALGORITHMS];
+    double idle_time[NUM_ALGORITHMS];
+    double shutdown_time[NUM_ALGORITHMS];
+    double discarded_exec[NUM_ALGORITHMS];
+    double discarded_avail[NUM_ALGORITHMS];
+} sweep_point_struct;
+
+/*
+    ADT for the parameters of the taskset generator.
+        num_tasks: The number of tasks of each taskset.
+        num_levels: The number of criticality levels. The criticality level of each task is chosen uniformly.
+        periods, num_periods: The set from which the periods are chosen, in increasing order. A period is drawn log-uniformly between the smallest and the largest
+                              period and rounded (in log scale) to the closest period of the set.
+        wcet_growth[l]: The factor by which the WCET at level l - 1 is multiplied to get the WCET at level l, for the tasks with criticality level >= l.
+        max_attempts: The number of UUniFast draws after which the generation of a taskset is given up, if every draw had a task with utilisation greater than 1.
+*/
+typedef struct generator_struct
+{
+    int num_tasks;
+    int num_levels;
+    const double *periods;
+    int num_periods;
+    double wcet_growth[MAX_GENERATOR_LEVELS];
+    int max_attempts;
+} generator_struct;
+
 typedef struct la_edf_struct
 {
     int task_number;
@@ -205,11 +606,35 @@ typedef struct la_edf_struct
     double exec_time;
 }la_edf_struct;
 
-FILE *output_file;
-FILE *output[NUM_CORES];
-stats_struct *stats;
+//The output files and the statistics are per thread, so that allocation heuristics and simulations running in parallel threads use their own.
+//All the globals are defined in auxiliary_functions.c.
+extern __thread FILE *output_file;
+extern __thread FILE *output[NUM_CORES];
+extern __thread stats_struct *stats;
 
-double frequency[FREQUENCY_LEVELS];
-int MAX_CRITICALITY_LEVELS;
+extern double frequency[FREQUENCY_LEVELS];
+extern int MAX_CRITICALITY_LEVELS;
+extern int allocation_mode;
+//If set, a core rejected by the utilisation-based EDF-VD test is checked with the exact demand-based test during allocation (check_demand_schedulability).
+extern int demand_allocation;
+//If greater than 0, the scheduling stops at this time instead of the super hyperperiod.
+extern double simulation_horizon;
+//If greater than 0, the scheduling is checked every convergence_window time units and stops when the metrics have converged within convergence_tolerance.
+extern double convergence_window;
+extern double convergence_tolerance;
+//If set, a discarded job which does not fit in the slack of its own core is placed at once on another core with enough slack (DPS and EDF_VD_DJ).
+extern int discarded_migration;
+//If greater than 0, the discarded queue holds at most discarded_capacity jobs. The jobs beyond it are evicted (evict_discarded_jobs).
+extern int discarded_capacity;
+//If set, a criticality change raises the criticality level of the core whose job overran its WCET counter only, and the other cores keep their level (DPS, EDF_VD and EDF_VD_DJ).
+extern int per_core_mode;
+//If set, the criticality level is lowered when a job completes, to the highest level of the jobs left in the ready queues (the lowest level at an idle instant).
+extern int mode_return;
+//If set, the discarded jobs readmitted to a ready queue are chosen by a knapsack over the slack of the core (select_discarded_jobs), maximising the sum of
+//readmission_value[l] times the remaining execution time of the readmitted jobs of criticality level l (MAX_CRITICALITY_LEVELS values).
+extern int knapsack_readmission;
+extern double *readmission_value;
+//If set, the criticality levels of the cores are checked after each criticality change and return (check_core_modes). It recounts the ready queues, for debugging.
+extern int mode_check;
 
 #endif
\ No newline at end of file
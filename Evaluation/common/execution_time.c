@@ -0,0 +1,431 @@
+#include "functions.h"
+
+/*
+    Function to create an execution time model with two parameters (EXEC_UNIFORM, EXEC_NORMAL, EXEC_WEIBULL or EXEC_GUMBEL).
+*/
+exec_model_struct *create_exec_model(int type, double param_1, double param_2)
+{
+    exec_model_struct *model = malloc(sizeof(exec_model_struct));
+
+    model->type = type;
+    model->param[0] = param_1;
+    model->param[1] = param_2;
+    model->values = NULL;
+    model->cdf = NULL;
+    model->num_bins = 0;
+
+    return model;
+}
+
+/*
+    Preconditions:
+        Input: {file pointer to the histogram}
+
+    Purpose of the function: Creates an empirical (EXEC_EMPIRICAL) execution time model from a histogram, e.g. a pWCET distribution measured on the target.
+                             Each line of the file has a value (relative to the WCET at the lowest level) and its probability. The probabilities are normalized.
+
+    Postconditions:
+        Output: {Pointer to the model. NULL if the file has no bins or a negative probability}
+*/
+exec_model_struct *load_exec_histogram(FILE *file)
+{
+    exec_model_struct *model = create_exec_model(EXEC_EMPIRICAL, 0.00, 0.00);
+    double value, probability, total = 0.00;
+    int size = 16, i, j;
+
+    model->values = malloc(sizeof(double) * size);
+    model->cdf = malloc(sizeof(double) * size);
+    while (fscanf(file, "%lf%lf", &value, &probability) == 2)
+    {
+        if (probability < 0.00)
+        {
+            free_exec_model(model);
+            return NULL;
+        }
+        if (model->num_bins == size)
+        {
+            size *= 2;
+            model->values = realloc(model->values, sizeof(double) * size);
+            model->cdf = realloc(model->cdf, sizeof(double) * size);
+        }
+
+        //Insert the bin in increasing order of value.
+        for (i = model->num_bins; i > 0 && model->values[i - 1] > value; i--)
+        {
+            model->values[i] = model->values[i - 1];
+            model->cdf[i] = model->cdf[i - 1];
+        }
+        model->values[i] = value;
+        model->cdf[i] = probability;
+        model->num_bins++;
+        total += probability;
+    }
+
+    if (model->num_bins == 0 || total <= 0.00)
+    {
+        free_exec_model(model);
+        return NULL;
+    }
+
+    for (j = 0, value = 0.00; j < model->num_bins; j++)
+    {
+        value += model->cdf[j] / total;
+        model->cdf[j] = value;
+    }
+    model->cdf[model->num_bins - 1] = 1.00;
+
+    return model;
+}
+
+/*
+    Function to free an execution time model.
+*/
+void free_exec_model(exec_model_struct *model)
+{
+    if (model == NULL)
+        return;
+
+    free(model->values);
+    free(model->cdf);
+    free(model);
+}
+
+/*
+    Function to check the parameters of an execution time model with two parameters: the maximum of a uniform model is not below its minimum and the standard
+    deviation, shape and scale of the other models are positive. Returns 1 if they are valid, else 0.
+*/
+static int check_exec_model_parameters(int type, double param_1, double param_2)
+{
+    if (isnan(param_1) || isnan(param_2))
+        return 0;
+
+    switch (type)
+    {
+    case EXEC_UNIFORM:
+        return (param_2 >= param_1);
+    case EXEC_NORMAL:
+    case EXEC_GUMBEL:
+        return (param_2 > 0.00);
+    case EXEC_WEIBULL:
+        return (param_1 > 0.00 && param_2 > 0.00);
+    }
+    return 0;
+}
+
+/*
+    Preconditions:
+        Input: {file pointer to the model file, pointer to the taskset}
+
+    Purpose of the function: Reads the execution time model of each task. Line i of the file is the model of task i of input_mcs.txt (the task with task_number i):
+                                default                         (the model of create_times.c)
+                                uniform <minimum> <maximum>
+                                normal <mean> <standard deviation>
+                                weibull <shape> <scale>
+                                gumbel <location> <scale>
+                                empirical <histogram file>
+                             The parameters are relative to the WCET of the task at the lowest criticality level. A model with invalid parameters (check_exec_model_parameters)
+                             is rejected.
+
+    Postconditions:
+        Output: {1 if the models of all the tasks were read, else 0}
+        Result: The exec_model of each task is set (NULL for default).
+*/
+int load_exec_models(FILE *file, task_set_struct *task_set)
+{
+    char type[32], path[256];
+    double param_1, param_2;
+    int task_number, i;
+    FILE *histogram_file;
+    task *curr_task;
+
+    for (task_number = 0; task_number < task_set->total_tasks; task_number++)
+    {
+        for (i = 0, curr_task = NULL; i < task_set->total_tasks; i++)
+        {
+            if (task_set->task_list[i].task_number == task_number)
+                curr_task = &(task_set->task_list[i]);
+        }
+
+        if (curr_task == NULL || fscanf(file, "%31s", type) != 1)
+            return 0;
+
+        curr_task->exec_model = NULL;
+        if (strcmp(type, "default") == 0)
+            continue;
+
+        if (strcmp(type, "empirical") == 0)
+        {
+            if (fscanf(file, "%255s", path) != 1 || (histogram_file = fopen(path, "r")) == NULL)
+            {
+                printf("ERROR: Cannot open histogram file of task %d\n", task_number);
+                return 0;
+            }
+            curr_task->exec_model = load_exec_histogram(histogram_file);
+            fclose(histogram_file);
+        }
+        else if (fscanf(file, "%lf%lf", &param_1, &param_2) == 2)
+        {
+            int model_type = 0;
+
+            if (strcmp(type, "uniform") == 0)
+                model_type = EXEC_UNIFORM;
+            else if (strcmp(type, "normal") == 0)
+                model_type = EXEC_NORMAL;
+            else if (strcmp(type, "weibull") == 0)
+                model_type = EXEC_WEIBULL;
+            else if (strcmp(type, "gumbel") == 0)
+                model_type = EXEC_GUMBEL;
+
+            if (check_exec_model_parameters(model_type, param_1, param_2))
+                curr_task->exec_model = create_exec_model(model_type, param_1, param_2);
+        }
+
+        if (curr_task->exec_model == NULL)
+        {
+            printf("ERROR: Invalid execution time model of task %d\n", task_number);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+    Function to free the execution time models of the tasks of a taskset (not of its copies, which share them).
+*/
+void free_exec_models(task_set_struct *task_set)
+{
+    int i;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        free_exec_model(task_set->task_list[i].exec_model);
+        task_set->task_list[i].exec_model = NULL;
+    }
+}
+
+/*
+    Function to find the quantile of the standard normal distribution at probability p (0 < p < 1): the rational approximation of Acklam, refined by one
+    Halley step on erfc, which gives full double precision.
+*/
+static double find_normal_quantile(double p)
+{
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+    double q, r, x, e;
+
+    if (p < 0.02425)
+    {
+        q = sqrt(-2.0 * log(p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    else if (p > 1.0 - 0.02425)
+    {
+        q = sqrt(-2.0 * log(1.0 - p));
+        x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    else
+    {
+        q = p - 0.5;
+        r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    }
+
+    e = 0.5 * erfc(-x / M_SQRT2) - p;
+    r = e * sqrt(2.0 * M_PI) * exp(x * x / 2.0);
+    return x - r / (1.0 + x * r / 2.0);
+}
+
+/*
+    Preconditions:
+        Input: {mean, standard deviation, bounds of the window, uniform random number u in [0, 1)}
+
+    Purpose of the function: Draws from the normal distribution truncated to [low, high] by inverse distribution function: u is mapped into the probability of the
+                             window and transformed by find_normal_quantile. A window in the upper tail uses the complementary probabilities, so that the far tails keep
+                             their precision. If the window has no representable probability, the bound nearest to the mean is returned.
+
+    Postconditions:
+        Output: {value in [low, high]}
+*/
+static double sample_truncated_normal(double mean, double stddev, double low, double high, double u)
+{
+    double z_low = (low - mean) / stddev, z_high = (high - mean) / stddev, p_low, p_high, x;
+
+    if (z_low > 0.00)
+    {
+        //Upper tail: P(Z > z) decreases from p_low to p_high over the window.
+        p_low = 0.5 * erfc(z_low / M_SQRT2);
+        p_high = 0.5 * erfc(z_high / M_SQRT2);
+        if (!(p_low > p_high))
+            return low;
+        x = -find_normal_quantile(p_low - u * (p_low - p_high));
+    }
+    else
+    {
+        p_low = 0.5 * erfc(-z_low / M_SQRT2);
+        p_high = 0.5 * erfc(-z_high / M_SQRT2);
+        if (!(p_high > p_low))
+            return (z_high < 0.00) ? high : low;
+        x = find_normal_quantile(p_low + u * (p_high - p_low));
+    }
+
+    return min(max(mean + stddev * x, low), high);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the model, WCET of the task at the lowest level, WCET of the task at its own level, array for the times, number of jobs, generator}
+
+    Purpose of the function: Draws the execution times of num_jobs jobs at once. The uniform random numbers are drawn first for the whole batch and then transformed
+                             by the inverse distribution function of the model in one loop per model type, so that the loops have no branches on the model.
+                             The normal distribution is truncated to [0, WCET at its own level] and sampled by inverse distribution function over that window
+                             (sample_truncated_normal), so its cost does not depend on the probability of the window.
+                             The times are scaled by the WCET at the lowest level, bounded by the WCET at the task's own level (the job cannot exceed its
+                             highest budget), at least MIN_EXECUTION_TIME and rounded to 2 decimals, as in the input files.
+
+    Postconditions:
+        Output: {void}
+        Result: times[0..num_jobs-1] contains the execution times.
+*/
+void sample_execution_times(exec_model_struct *model, double WCET, double max_WCET, double *times, int num_jobs, rng_struct *rng)
+{
+    double a = model->param[0], b = model->param[1], max_time = max_WCET / WCET;
+    int i, bin;
+
+    for (i = 0; i < num_jobs; i++)
+    {
+        times[i] = rng_uniform(rng);
+    }
+
+    switch (model->type)
+    {
+    case EXEC_UNIFORM:
+        for (i = 0; i < num_jobs; i++)
+            times[i] = a + (b - a) * times[i];
+        break;
+
+    case EXEC_NORMAL:
+        for (i = 0; i < num_jobs; i++)
+            times[i] = sample_truncated_normal(a, b, 0.00, max_time, times[i]);
+        break;
+
+    case EXEC_WEIBULL:
+        for (i = 0; i < num_jobs; i++)
+            times[i] = b * pow(-log(1.0 - times[i]), 1.0 / a);
+        break;
+
+    case EXEC_GUMBEL:
+        for (i = 0; i < num_jobs; i++)
+            times[i] = a - b * log(-log(times[i] + 1e-300));
+        break;
+
+    case EXEC_EMPIRICAL:
+        for (i = 0; i < num_jobs; i++)
+        {
+            int low = 0, high = model->num_bins - 1;
+            while (low < high)
+            {
+                bin = (low + high) / 2;
+                if (model->cdf[bin] > times[i])
+                    high = bin;
+                else
+                    low = bin + 1;
+            }
+            times[i] = model->values[low];
+        }
+        break;
+    }
+
+    for (i = 0; i < num_jobs; i++)
+    {
+        times[i] = round(100 * min(times[i] * WCET, max_WCET)) / 100;
+        times[i] = max(MIN_EXECUTION_TIME, times[i]);
+    }
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the task, job number}
+
+    Purpose of the function: Returns the execution time of the job. If the execution times of the task were not generated in advance (exec_times is NULL),
+                             the execution time is replayed from the trace of the task if it has one. Otherwise the batch of EXEC_BATCH_SIZE jobs which contains the job is drawn from the model of the task, using the stream of exec_rng
+                             with the number of the batch, and kept in the cache of the task.
+
+    Postconditions:
+        Output: {The execution time of the job}
+*/
+double find_job_execution_time(task *curr_task, int job_number)
+{
+    int batch;
+    rng_struct rng;
+
+    if (curr_task->exec_times != NULL)
+        return curr_task->exec_times[job_number];
+    if (curr_task->trace != NULL)
+        return find_trace_execution_time(curr_task->trace, job_number);
+
+    batch = job_number / EXEC_BATCH_SIZE;
+    if (curr_task->exec_cache == NULL)
+    {
+        curr_task->exec_cache = malloc(sizeof(double) * EXEC_BATCH_SIZE);
+        curr_task->exec_batch = -1;
+    }
+    if (curr_task->exec_batch != batch)
+    {
+        rng = rng_split(&(curr_task->exec_rng), batch);
+        sample_execution_times(curr_task->exec_model, curr_task->WCET[0], curr_task->WCET[curr_task->criticality_lvl], curr_task->exec_cache, EXEC_BATCH_SIZE, &rng);
+        curr_task->exec_batch = batch;
+    }
+
+    return curr_task->exec_cache[job_number % EXEC_BATCH_SIZE];
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the task, first job number, number of jobs}
+
+    Purpose of the function: Returns the total execution time of the jobs first_job to first_job + num_jobs - 1. If the execution times of the task were
+                             generated in advance, the total is the difference of two running sums of exec_times, which are extended up to the last job when needed
+                             (the array grows by doubling). Otherwise the execution times are added one by one, as they are replayed from a trace or drawn in batches.
+
+    Postconditions:
+        Output: {The total execution time of the jobs}
+*/
+double find_jobs_execution_time(task *curr_task, int first_job, int num_jobs)
+{
+    int last_job = first_job + num_jobs, j;
+    double total = 0.00;
+
+    if (num_jobs <= 0)
+        return 0.00;
+
+    if (curr_task->exec_times == NULL)
+    {
+        for (j = first_job; j < last_job; j++)
+            total += find_job_execution_time(curr_task, j);
+        return total;
+    }
+
+    if (curr_task->exec_prefix == NULL)
+    {
+        curr_task->prefix_size = max_int(EXEC_BATCH_SIZE, last_job + 1);
+        curr_task->exec_prefix = malloc(sizeof(double) * curr_task->prefix_size);
+        curr_task->exec_prefix[0] = 0.00;
+        curr_task->num_prefix = 1;
+    }
+    if (last_job >= curr_task->num_prefix)
+    {
+        if (last_job >= curr_task->prefix_size)
+        {
+            curr_task->prefix_size = max_int(2 * curr_task->prefix_size, last_job + 1);
+            curr_task->exec_prefix = realloc(curr_task->exec_prefix, sizeof(double) * curr_task->prefix_size);
+        }
+        for (j = curr_task->num_prefix; j <= last_job; j++)
+            curr_task->exec_prefix[j] = curr_task->exec_prefix[j - 1] + curr_task->exec_times[j - 1];
+        curr_task->num_prefix = last_job + 1;
+    }
+
+    return curr_task->exec_prefix[last_job] - curr_task->exec_prefix[first_job];
+}
@@ -28,6 +28,57 @@ extern processor_struct *initialize_processor();
                 Else it will return 0.
 */
 extern int allocate_tasks_to_cores(task_set_struct *task_set, processor_struct *processor);
+extern void free_processor(processor_struct *processor);
+extern void find_shutdown_tasks(task_set_struct *task_set);
+extern void finalize_allocation(task_set_struct *task_set, processor_struct *processor, FILE *cores_file);
+
+/*
+    Preconditions:
+        Input: {Pointer to taskset, pointer to processor, allocation file}
+                The shutdown and non-shutdown tasks are found and no task is allocated.
+
+    Purpose of the function: Runs a portfolio of allocation heuristics (fit rule, allocation order and MAX_UTIL cap) in parallel threads, estimates the energy
+                             of each feasible allocation and applies the one with the lowest energy. Only available in DPS (allocation_portfolio.c).
+
+    Postconditions:
+        Output: 1 if one of the heuristics allocated all the tasks, else 0.
+*/
+extern int allocate_tasks_portfolio(task_set_struct *task_set, processor_struct *processor, FILE *allocation_file);
+extern int allocate_with_heuristic(task_set_struct *task_set, processor_struct *processor, heuristic_struct heuristic);
+extern void estimate_allocation_energy(task_set_struct *task_set, processor_struct *processor, allocation_struct *allocation);
+extern int find_portfolio_allocation(task_set_struct *task_set, int num_cores, allocation_struct *result);
+extern void apply_allocation(task_set_struct *task_set, processor_struct *processor, allocation_struct *allocation, FILE *allocation_file);
+extern void free_allocation(allocation_struct *allocation);
+
+/*
+    Preconditions:
+        Input: {Pointer to taskset, pointer to processor, allocation file}
+                The shutdown and non-shutdown tasks are found and no task is allocated.
+
+    Purpose of the function: Starting from the allocation of the portfolio, searches for the allocation with the lowest total active and idle time with simulated annealing
+                             over task moves and swaps between cores. Each candidate is checked with the EDF-VD schedulability test and evaluated with a DPS simulation
+                             truncated to OPTIMIZER_HORIZON_PERIODS periods, in parallel threads. Only available in DPS (allocation_optimizer.c).
+
+    Postconditions:
+        Output: 1 if a feasible allocation was found, else 0.
+*/
+extern int allocate_tasks_optimized(task_set_struct *task_set, processor_struct *processor, FILE *allocation_file);
+
+/*
+    Preconditions:
+        Input: {Pointer to taskset, pointer to processor, allocation file}
+                The shutdown and non-shutdown tasks are found and no task is allocated.
+
+    Purpose of the function: Searches (exponential, then binary search) for the minimum number of cores on which the portfolio allocates all the tasks, reports it and
+                             applies that allocation. The heuristics at each number of cores run in parallel threads. Only available in DPS (allocation_portfolio.c).
+
+    Postconditions:
+        Output: 1 if the tasks can be allocated on at most NUM_CORES cores, else 0.
+*/
+extern int allocate_tasks_minimum_cores(task_set_struct *task_set, processor_struct *processor, FILE *allocation_file);
+extern int find_minimum_cores(task_set_struct *task_set, allocation_struct *result);
+extern void save_allocation(task_set_struct *task_set, processor_struct *processor, allocation_struct *allocation);
+extern int run_simulation(task_set_struct *task_set, allocation_struct *allocation, int algo);
 /*--------------------------------------------------------------------------*/
 
 /*---------------------------SCHEDULER FUNCTIONS---------------------------*/
@@ -59,26 +110,178 @@ extern void runtime_scheduler(task_set_struct *task_set, processor_struct *proce
 extern double find_max_slack(task_set_struct *task_set, int crit_level, int core_no, double deadline, double curr_time, job_queue_struct *ready_queue);
 extern double find_superhyperperiod(task_set_struct *task_set);
 extern double find_earliest_arrival_job(task_set_struct *task_set, int core_no, int curr_crit_level);
+extern decision_struct find_core_decision_point(task_set_struct *task_set, processor_struct *processor, int core_no);
 extern decision_struct find_decision_point(task_set_struct *task_set, processor_struct *processor, double super_hyperperiod);
+extern int find_decision_points(task_set_struct *task_set, processor_struct *processor, decision_struct decisions[]);
+extern void fast_forward_idle_cores(processor_struct *processor, double curr_time);
+extern void select_discarded_jobs(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int core_no, int curr_crit_level, double curr_time);
 extern void accommodate_discarded_jobs(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int core_no, int curr_crit_level, double curr_time);
-extern void update_job_arrivals(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int curr_crit_level, double curr_time, int core_no, core_struct *core, int algo, int timer_expiry);
+extern int find_missed_jobs(task *curr_task, double curr_time);
+extern slack_index_struct *initialize_slack_index(processor_struct *processor);
+extern void free_slack_index(slack_index_struct *slack_index);
+extern void update_slack_index(processor_struct *processor, task_set_struct *task_set, int core_no);
+extern double estimate_core_slack(slack_index_struct *slack_index, int core_no, double deadline, double curr_time);
+extern int migrate_discarded_job(processor_struct *processor, task_set_struct *task_set, job *discarded_job, int core_no, double curr_time);
+extern void update_job_arrivals(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int curr_crit_level, double curr_time, int core_no, processor_struct *processor, int algo, int timer_expiry);
 extern void update_job_removal(task_set_struct *taskset, job_queue_struct **ready_queue);
 extern void schedule_new_job(core_struct *core, job_queue_struct *ready_queue, task_set_struct *task_set);
 /*-------------------------------------------------------------------------*/
 
+/*---------------------------SCHEDULER LOOP---------------------------*/
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, algorithm (DPS, EDF_VD, EDF_VD_DJ or EDF)}
+                The tasks are allocated and the task table of each core is built.
+
+    Purpose of the function: Runs the scheduler of the given algorithm up to the super hyperperiod (or simulation_horizon, if it is set).
+                             If convergence_window is set, the run stops at the end of the first window at which the metrics have converged.
+                             Shared by the drivers of all the algorithms and by the in-process simulations (allocation optimizer, sweep).
+
+    Postconditions:
+        Output: {void}
+        Result: The statistics of the run are accumulated in stats.
+*/
+extern void schedule_taskset(task_set_struct *task_set, processor_struct *processor, int algo);
+extern void parse_options(int argc, char *argv[]);
+/*--------------------------------------------------------------------*/
+
 /*---------------------------PROCRASTINATION FUNCTIONS---------------------------*/
 extern double find_procrastination_interval(double curr_time, task_set_struct *task_set, int curr_crit_level, int core_no);
 /*-------------------------------------------------------------------------------*/
 
+/*---------------------------TASK TABLE FUNCTIONS---------------------------*/
+extern void build_task_table(task_set_struct *task_set);
+extern void update_task_table(task_set_struct *task_set, int task_number);
+extern double find_min_next_release(task_table_struct *table, int start, int end);
+extern int find_next_job_number(task_table_struct *table, int pos, double time, int inclusive);
+extern void free_task_table(task_set_struct *task_set);
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------TASKSET GENERATOR FUNCTIONS---------------------------*/
+extern rng_struct rng_init(unsigned long long seed);
+extern rng_struct rng_split(rng_struct *rng, unsigned long long stream);
+extern unsigned long long rng_next(rng_struct *rng);
+extern double rng_uniform(rng_struct *rng);
+extern void initialize_generator_struct(generator_struct *generator, int num_tasks, int period_set);
+extern void generate_execution_times(task_set_struct *task_set, rng_struct *rng);
+extern task_set_struct *generate_taskset(generator_struct *generator, double utilisation, rng_struct *rng);
+extern task_set_struct *derive_single_criticality_taskset(task_set_struct *task_set);
+extern void free_generated_taskset(task_set_struct *task_set, int free_exec_times);
+extern int write_taskset_binary(FILE *file, task_set_struct *task_set);
+extern task_set_struct *read_taskset_binary(FILE *file);
+extern void write_execution_times_text(task_set_struct *task_set, FILE *times_file);
+extern void write_taskset_text(task_set_struct *task_set, FILE *mcs_file, FILE *rts_file, FILE *times_file);
+extern task_set_struct *read_taskset_text(FILE *mcs_file);
+/*---------------------------------------------------------------------------------*/
+
+/*---------------------------EXECUTION TIME FUNCTIONS---------------------------*/
+extern exec_model_struct *create_exec_model(int type, double param_1, double param_2);
+extern exec_model_struct *load_exec_histogram(FILE *file);
+extern void free_exec_model(exec_model_struct *model);
+extern int load_exec_models(FILE *file, task_set_struct *task_set);
+extern void free_exec_models(task_set_struct *task_set);
+extern void sample_execution_times(exec_model_struct *model, double WCET, double max_WCET, double *times, int num_jobs, rng_struct *rng);
+extern double find_job_execution_time(task *curr_task, int job_number);
+extern double find_jobs_execution_time(task *curr_task, int first_job, int num_jobs);
+/*-------------------------------------------------------------------------------*/
+
+/*---------------------------TRACE REPLAY FUNCTIONS---------------------------*/
+extern trace_struct *create_trace(const char *path);
+extern void copy_traces(task_set_struct *task_set);
+extern void free_trace(trace_struct *trace);
+extern int load_traces(FILE *traces_file, task_set_struct *task_set);
+extern double find_trace_execution_time(trace_struct *trace, int job_number);
+/*----------------------------------------------------------------------------*/
+
+/*---------------------------PROBABILISTIC ANALYSIS FUNCTIONS---------------------------*/
+extern pmf_struct *find_task_pmf(task *curr_task, double horizon);
+extern void free_pmf(pmf_struct *pmf);
+extern double find_overrun_probability(pmf_struct *pmf, double budget);
+extern double find_mode_switch_probability(task_set_struct *task_set, int core_no, double horizon);
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, core number, horizon}
+                The task index of the core is filled.
+
+    Purpose of the function: Computes the deadline miss probability and the mode switch probability of the core over the horizon from the execution time
+                             distributions of its tasks. The distribution of the demand is built with FFT convolutions on a lattice of at most MAX_PMF_BINS bins.
+
+    Postconditions:
+        Output: {The probabilities of the core}
+*/
+extern probability_struct analyse_core_probability(task_set_struct *task_set, int core_no, double horizon);
+/*--------------------------------------------------------------------------------------*/
+
+/*---------------------------SIMULATION FUNCTIONS---------------------------*/
+//In-process simulations of an allocation with every algorithm, shared by the sweep and the campaign (common/simulation.c).
+extern const char *find_algorithm_name(int num_algo);
+extern double find_energy(double active_time, double idle_time);
+extern FILE *discard_thread_output();
+extern void run_all_algorithms(task_set_struct *task_set, allocation_struct *allocation, simulation_result_struct *results);
+/*--------------------------------------------------------------------------*/
+
+/*---------------------------SWEEP FUNCTIONS---------------------------*/
+extern sweep_point_struct *run_sweep(double min_util, double max_util, double step, int num_samples, int num_tasks, int *num_points);
+extern void write_sweep_csv(FILE *csv_file, sweep_point_struct *points, int num_points);
+/*---------------------------------------------------------------------*/
+
+/*---------------------------CAMPAIGN FUNCTIONS---------------------------*/
+extern void run_campaign(task_set_struct *task_set, allocation_struct *allocation, int num_realizations, unsigned long long seed, FILE *csv_file);
+extern void write_campaign_metric(FILE *csv_file, const char *algorithm, const char *metric, double *values, double *base_values, int *completed, int *base_completed, int num_realizations);
+/*------------------------------------------------------------------------*/
+
 /*---------------------------CHECK FUNCTIONS---------------------------*/
 extern x_factor_struct check_schedulability(task_set_struct *task_set, int core_no);
+extern x_factor_struct check_core_schedulability(core_struct *core);
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to core, core number}
+                The task index of the core and the utilisation matrix of the core contain the tasks allocated to it.
+
+    Purpose of the function: Exact EDF-VD test of the core with the demand bound functions of the LO mode and of the HI mode with carry-over jobs, checked with
+                             Quick Processor-demand Analysis. The utilisation-based test is tried first; the demand test is only run when it rejects the core.
+                             If no single x-factor passes, the virtual deadline of each HI task is tuned separately.
+
+    Postconditions:
+        Output: {x-factor and threshold level of the core (tuned = 1 if per-task factors are needed). If the core is not schedulable, x = 0}
+*/
+extern x_factor_struct check_demand_schedulability(task_set_struct *task_set, core_struct *core, int core_no);
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, core number, x-factor returned by check_demand_schedulability for the core}
+
+    Purpose of the function: Stores the tuned virtual deadline factors in the tasks of the core, or clears them if the core uses a single x-factor.
+
+    Postconditions:
+        Output: {void}
+*/
+extern void set_deadline_factors(task_set_struct *task_set, int core_no, x_factor_struct x_factor);
+extern x_factor_struct find_x_factor(double total_utilisation[][MAX_CRITICALITY_LEVELS]);
+extern void find_total_utilisation(task_set_struct *task_set, double total_utilisation[][MAX_CRITICALITY_LEVELS], int core_no);
+extern void add_task_utilisation(core_struct *core, task *new_task);
+extern void remove_task_utilisation(core_struct *core, task *old_task);
 /*---------------------------------------------------------------------*/
 
 /*---------------------------QUEUE FUNCTIONS---------------------------*/
+extern job_queue_struct *initialize_job_queue();
+extern void free_job_queue(job_queue_struct *queue);
+extern double find_job_deadline(job *curr_job);
+extern void update_job_budget(job *curr_job, int level);
+extern int precedes_job(job *A, job *B);
+extern job *find_earliest_job(job_queue_struct *queue);
+extern job *next_job_in_order(job **cursor);
+extern void insert_job_in_list(job **head, job *new_job);
+extern int merge_jobs_in_discarded_list(job **discarded_head, job *ready_head, int mode_level, int core_no);
+extern void evict_discarded_jobs(job_queue_struct **discarded_queue);
 extern void insert_job_in_discarded_queue(job_queue_struct **discarded_queue, job *new_job, task *task_list, int core_no);
 extern void remove_jobs_from_discarded_queue(job_queue_struct **discarded_queue, double curr_time);
+extern void sort_discarded_jobs(job_queue_struct **discarded_queue, int core_no, int threshold_crit_lvl);
+extern void count_ready_job(job_queue_struct *ready_queue, job *curr_job, int count);
 extern void insert_job_in_ready_queue(job_queue_struct **ready_queue, job *new_job);
-extern void remove_jobs_from_ready_queue(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task *task_list, int curr_crit_lvl, int k, int core_no);
+extern void remove_jobs_from_ready_queue(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, int curr_crit_lvl, int deadlines_reset, int core_no);
 /*---------------------------------------------------------------------*/
 
 /*---------------------------AUXILIARY FUNCTIONS---------------------------*/
@@ -90,19 +293,30 @@ extern int min_int(int a, int b);
 extern int period_comparator(const void *p, const void *q);
 extern void print_task_list(task_set_struct *task_set);
 extern void print_job_list(int core_no, job *job_list_head);
+extern void print_job_queue(int core_no, job_queue_struct *queue);
 extern void print_total_utilisation(double total_utilisation[][MAX_CRITICALITY_LEVELS]);
 extern void print_processor(processor_struct *processor);
 extern int compare_jobs(job *A, job *B);
 extern double find_actual_execution_time(double exec_time, int task_crit_lvl, int core_crit_lvl);
 extern void set_virtual_deadlines(task_set_struct **task_set, int core_no, double x, int k);
-extern void reset_virtual_deadlines(task_set_struct **task_set, int core_no, int k);
+extern int reset_virtual_deadlines(task_set_struct **task_set, int core_no, int k);
 extern void set_execution_times(job* curr_job, double frequency);
 extern void reset_execution_times(job* curr_job, double frequency);
 extern void set_utilisation(task* task, int curr_crit_level, double exec_time);
 extern void reset_utilisation(task* task, int curr_crit_level);
 extern int check_all_cores(processor_struct *processor);
 extern int find_max_level(processor_struct *processor, task_set_struct *task_set);
+extern int check_core_modes(processor_struct *processor, task_set_struct *task_set);
 extern stats_struct* initialize_stats_struct();
+extern void free_stats_struct(stats_struct *stats);
+extern void initialize_task_index(task_set_struct *task_set);
+extern void add_task_to_index(task_set_struct *task_set, int task_number, int core_no);
+extern void remove_task_from_index(task_set_struct *task_set, int task_number, int core_no);
+extern void build_task_index(task_set_struct *task_set);
+extern void load_deadline_factors(task_set_struct *task_set);
+extern void free_task_index(task_set_struct *task_set);
+extern task_set_struct *copy_task_set(task_set_struct *task_set);
+extern void free_task_set_copy(task_set_struct *task_set);
 /*-------------------------------------------------------------------------*/
 
 #endif
\ No newline at end of file
@@ -0,0 +1,475 @@
+#include "functions.h"
+
+/*
+    Function to find the cumulative distribution function of a parametric execution time model at x (relative to the WCET at the lowest level),
+    before the truncation at the WCET at the task's own level.
+*/
+static double find_model_cdf(exec_model_struct *model, double x)
+{
+    double a = model->param[0], b = model->param[1];
+
+    switch (model->type)
+    {
+    case EXEC_UNIFORM:
+        return (x <= a) ? 0.00 : ((x >= b) ? 1.00 : (x - a) / (b - a));
+    case EXEC_NORMAL:
+        return 0.5 * (1.0 + erf((x - a) / (b * sqrt(2.0))));
+    case EXEC_WEIBULL:
+        return (x <= 0.00) ? 0.00 : 1.0 - exp(-pow(x / b, a));
+    case EXEC_GUMBEL:
+        return exp(-exp(-(x - a) / b));
+    }
+    return 1.00;
+}
+
+/*
+    Function to compare two doubles for qsort.
+*/
+static int double_comparator(const void *p, const void *q)
+{
+    double l = *(const double *)p, r = *(const double *)q;
+    return (l > r) - (l < r);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the task, horizon}
+
+    Purpose of the function: Finds the distribution of the execution time of a job of the task.
+                             If the task has a model, the model is discretized into PMF_MODEL_POINTS bins between 0 and the WCET at the task's own level; the probability
+                             of a bin is put on its upper edge, and the probability above the WCET at the task's own level on that WCET, as sample_execution_times does.
+                             Otherwise, the distribution is the histogram of the execution times of the jobs released before the horizon (from exec_times or the trace),
+                             or the WCET at the lowest level if the task has no execution times.
+
+    Postconditions:
+        Output: {Pointer to the distribution, to be freed with free_pmf}
+        Result: The values of the distribution are distinct and in increasing order.
+*/
+pmf_struct *find_task_pmf(task *curr_task, double horizon)
+{
+    pmf_struct *pmf = malloc(sizeof(pmf_struct));
+    exec_model_struct *model = curr_task->exec_model;
+    double WCET = curr_task->WCET[0], max_WCET = curr_task->WCET[curr_task->criticality_lvl];
+    double lower, upper, value;
+    int num_jobs, i, j;
+
+    if (model != NULL && model->type == EXEC_EMPIRICAL)
+    {
+        pmf->num_points = model->num_bins;
+        pmf->value = malloc(sizeof(double) * model->num_bins);
+        pmf->prob = malloc(sizeof(double) * model->num_bins);
+        for (i = 0; i < model->num_bins; i++)
+        {
+            pmf->value[i] = max(MIN_EXECUTION_TIME, min(model->values[i] * WCET, max_WCET));
+            pmf->prob[i] = model->cdf[i] - ((i > 0) ? model->cdf[i - 1] : 0.00);
+        }
+    }
+    else if (model != NULL)
+    {
+        pmf->num_points = PMF_MODEL_POINTS;
+        pmf->value = malloc(sizeof(double) * PMF_MODEL_POINTS);
+        pmf->prob = malloc(sizeof(double) * PMF_MODEL_POINTS);
+
+        //The normal distribution is truncated at [0, WCET at the task's own level], the others are capped at the WCET.
+        lower = (model->type == EXEC_NORMAL) ? find_model_cdf(model, 0.00) : 0.00;
+        upper = (model->type == EXEC_NORMAL) ? find_model_cdf(model, max_WCET / WCET) : 1.00;
+        for (i = 0; i < PMF_MODEL_POINTS; i++)
+        {
+            pmf->value[i] = max_WCET * (i + 1) / PMF_MODEL_POINTS;
+            value = (i == PMF_MODEL_POINTS - 1) ? upper : min(upper, find_model_cdf(model, pmf->value[i] / WCET));
+            pmf->prob[i] = (max(value, lower) - lower) / (upper - lower);
+        }
+        for (i = PMF_MODEL_POINTS - 1; i > 0; i--)
+        {
+            pmf->prob[i] -= pmf->prob[i - 1];
+        }
+    }
+    else if (curr_task->exec_times != NULL || curr_task->trace != NULL)
+    {
+        num_jobs = max_int(1, (int)ceil((horizon - curr_task->phase) / curr_task->period));
+        pmf->num_points = num_jobs;
+        pmf->value = malloc(sizeof(double) * num_jobs);
+        pmf->prob = malloc(sizeof(double) * num_jobs);
+        for (i = 0; i < num_jobs; i++)
+        {
+            pmf->value[i] = find_job_execution_time(curr_task, i);
+            pmf->prob[i] = 1.00 / num_jobs;
+        }
+        qsort(pmf->value, num_jobs, sizeof(double), double_comparator);
+    }
+    else
+    {
+        pmf->num_points = 1;
+        pmf->value = malloc(sizeof(double));
+        pmf->prob = malloc(sizeof(double));
+        pmf->value[0] = WCET;
+        pmf->prob[0] = 1.00;
+    }
+
+    //Merge the equal values.
+    for (i = 0, j = 0; i < pmf->num_points; i++)
+    {
+        if (j > 0 && pmf->value[i] == pmf->value[j - 1])
+        {
+            pmf->prob[j - 1] += pmf->prob[i];
+            continue;
+        }
+        pmf->value[j] = pmf->value[i];
+        pmf->prob[j] = pmf->prob[i];
+        j++;
+    }
+    pmf->num_points = j;
+
+    return pmf;
+}
+
+void free_pmf(pmf_struct *pmf)
+{
+    if (pmf == NULL)
+        return;
+
+    free(pmf->value);
+    free(pmf->prob);
+    free(pmf);
+}
+
+/*
+    Function to find the probability that a value of the distribution is greater than the budget, e.g. that a job overruns its WCET at the lowest level.
+*/
+double find_overrun_probability(pmf_struct *pmf, double budget)
+{
+    double probability = 0.00;
+    int i;
+
+    for (i = pmf->num_points - 1; i >= 0 && pmf->value[i] > budget; i--)
+    {
+        probability += pmf->prob[i];
+    }
+    return min(1.00, probability);
+}
+
+/*
+    Preconditions:
+        Input: {real and imaginary parts, size (power of 2), 1 for the inverse transform}
+
+    Purpose of the function: In-place iterative radix-2 fast Fourier transform. The inverse transform is scaled by 1 / n.
+
+    Postconditions:
+        Output: {void}
+*/
+static void fft(double *re, double *im, int n, int inverse)
+{
+    int i, j, k, len;
+    double angle, w_re, w_im, u_re, u_im, v_re, v_im, cur_re, cur_im, tmp;
+
+    //Bit reversal permutation.
+    for (i = 1, j = 0; i < n; i++)
+    {
+        for (k = n >> 1; j & k; k >>= 1)
+            j ^= k;
+        j ^= k;
+        if (i < j)
+        {
+            tmp = re[i], re[i] = re[j], re[j] = tmp;
+            tmp = im[i], im[i] = im[j], im[j] = tmp;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1)
+    {
+        angle = 2.0 * M_PI / len * (inverse ? 1.0 : -1.0);
+        w_re = cos(angle);
+        w_im = sin(angle);
+        for (i = 0; i < n; i += len)
+        {
+            cur_re = 1.0;
+            cur_im = 0.0;
+            for (j = 0; j < len / 2; j++)
+            {
+                u_re = re[i + j];
+                u_im = im[i + j];
+                v_re = re[i + j + len / 2] * cur_re - im[i + j + len / 2] * cur_im;
+                v_im = re[i + j + len / 2] * cur_im + im[i + j + len / 2] * cur_re;
+                re[i + j] = u_re + v_re;
+                im[i + j] = u_im + v_im;
+                re[i + j + len / 2] = u_re - v_re;
+                im[i + j + len / 2] = u_im - v_im;
+
+                tmp = cur_re * w_re - cur_im * w_im;
+                cur_im = cur_re * w_im + cur_im * w_re;
+                cur_re = tmp;
+            }
+        }
+    }
+
+    if (inverse)
+    {
+        for (i = 0; i < n; i++)
+        {
+            re[i] /= n;
+            im[i] /= n;
+        }
+    }
+}
+
+/*
+    Preconditions:
+        Input: {distribution of the demand (num_bins values, with space for num_bins + job_bins - 1), distribution of the job (job_bins values)}
+
+    Purpose of the function: Convolves the distribution of the demand with the distribution of the job, on the same lattice. Small distributions are convolved directly,
+                             larger ones with the FFT. The rounding errors of the FFT (negative or tiny probabilities) are cleared.
+
+    Postconditions:
+        Output: {The number of bins of the result}
+        Result: demand contains the distribution of the sum.
+*/
+static int convolve_pmf(double *demand, int num_bins, double *job, int job_bins)
+{
+    int num_result = num_bins + job_bins - 1, size, i, j;
+    double *re, *im, *job_re, *job_im, tmp;
+
+    if (min_int(num_bins, job_bins) <= FFT_THRESHOLD)
+    {
+        double *result = calloc(num_result, sizeof(double));
+        for (i = 0; i < num_bins; i++)
+        {
+            if (demand[i] == 0.00)
+                continue;
+            for (j = 0; j < job_bins; j++)
+                result[i + j] += demand[i] * job[j];
+        }
+        memcpy(demand, result, sizeof(double) * num_result);
+        free(result);
+        return num_result;
+    }
+
+    for (size = 1; size < num_result; size <<= 1)
+        ;
+    re = calloc(size, sizeof(double));
+    im = calloc(size, sizeof(double));
+    job_re = calloc(size, sizeof(double));
+    job_im = calloc(size, sizeof(double));
+    memcpy(re, demand, sizeof(double) * num_bins);
+    memcpy(job_re, job, sizeof(double) * job_bins);
+
+    fft(re, im, size, 0);
+    fft(job_re, job_im, size, 0);
+    for (i = 0; i < size; i++)
+    {
+        tmp = re[i] * job_re[i] - im[i] * job_im[i];
+        im[i] = re[i] * job_im[i] + im[i] * job_re[i];
+        re[i] = tmp;
+    }
+    fft(re, im, size, 1);
+
+    for (i = 0; i < num_result; i++)
+    {
+        demand[i] = (re[i] > 1e-15) ? re[i] : 0.00;
+    }
+
+    free(re);
+    free(im);
+    free(job_re);
+    free(job_im);
+    return num_result;
+}
+
+/*
+    Function to put a distribution on the lattice of the given width. Value v is put in bin ceil(v / width), so the demand is never underestimated.
+    Returns the number of bins; bins has space for MAX_PMF_BINS values.
+*/
+static int discretize_pmf(pmf_struct *pmf, double width, double *bins)
+{
+    int i, bin, num_bins = 0;
+
+    for (i = 0; i < pmf->num_points; i++)
+    {
+        bin = min_int(MAX_PMF_BINS - 1, (int)ceil(pmf->value[i] / width - 1e-9));
+        for (; num_bins <= bin; num_bins++)
+            bins[num_bins] = 0.00;
+        bins[bin] += pmf->prob[i];
+    }
+    return num_bins;
+}
+
+/*
+    Function to compare two jobs of the probabilistic analysis by their deadline (jobs[2 * i] is the deadline of job i, jobs[2 * i + 1] its task).
+*/
+static int deadline_comparator(const void *p, const void *q)
+{
+    const double *l = (const double *)p, *r = (const double *)q;
+    if (l[0] != r[0])
+        return (l[0] > r[0]) - (l[0] < r[0]);
+    return (l[1] > r[1]) - (l[1] < r[1]);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, core number, horizon}
+                The task index of the core is filled.
+
+    Purpose of the function: Finds the probability that at least one job of the core released before the horizon overruns its WCET at the lowest criticality level,
+                             i.e., that the core leaves the lowest criticality mode. The jobs are independent, so it is 1 - prod (1 - p_i)^n_i over the tasks
+                             with criticality level > 0, where p_i is the overrun probability of a job of task i and n_i the number of its jobs.
+
+    Postconditions:
+        Output: {The mode switch probability}
+*/
+double find_mode_switch_probability(task_set_struct *task_set, int core_no, double horizon)
+{
+    task_index_struct *index = &(task_set->core_index[core_no]);
+    double log_no_switch = 0.00, overrun;
+    int crit_level, i, num_jobs;
+    task *curr_task;
+    pmf_struct *pmf;
+
+    for (crit_level = 1; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+    {
+        for (i = 0; i < index->num_tasks[crit_level]; i++)
+        {
+            curr_task = &(task_set->task_list[index->task_list[crit_level][i]]);
+            num_jobs = (int)ceil((horizon - curr_task->phase) / curr_task->period);
+            if (num_jobs <= 0)
+                continue;
+
+            pmf = find_task_pmf(curr_task, horizon);
+            overrun = find_overrun_probability(pmf, curr_task->WCET[0]);
+            free_pmf(pmf);
+
+            if (overrun >= 1.00)
+                return 1.00;
+            log_no_switch += num_jobs * log1p(-overrun);
+        }
+    }
+
+    return 1.00 - exp(log_no_switch);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, core number, horizon}
+                The task index of the core is filled.
+
+    Purpose of the function: Probabilistic analysis of the core over the horizon, from the execution time distribution of each task (find_task_pmf).
+                             The jobs released before the horizon are taken in increasing order of deadline and the distribution of the demand (the total execution time
+                             of the jobs with deadline <= t) is built by convolving the distributions of the jobs one by one, with the FFT. At each deadline t,
+                             the probability that the demand is greater than t is the probability that the jobs cannot meet their deadlines on the core at the
+                             maximum frequency. The deadline miss probability is the largest of these probabilities.
+                             The demand lives on a lattice of at most MAX_PMF_BINS bins: when the demand grows beyond it, the lattice is resampled at twice the
+                             width by merging pairs of bins (the merged probability is put on the larger value). The lattice starts at a width of 0.01,
+                             the precision of the execution times.
+
+    Postconditions:
+        Output: {The deadline miss probability and the mode switch probability of the core}
+*/
+probability_struct analyse_core_probability(task_set_struct *task_set, int core_no, double horizon)
+{
+    task_index_struct *index = &(task_set->core_index[core_no]);
+    probability_struct result;
+    int crit_level, i, j, b, num_tasks = 0, num_jobs = 0, num_bins = 1, job_bins;
+    int *task_numbers, *task_bins;
+    double width = 0.01, deadline, miss, *jobs, *demand, **task_pmfs, release, max_value = 0.00;
+    pmf_struct **pmfs;
+    task *curr_task;
+
+    result.mode_switch = find_mode_switch_probability(task_set, core_no, horizon);
+    result.deadline_miss = 0.00;
+
+    for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+    {
+        num_tasks += index->num_tasks[crit_level];
+    }
+    if (num_tasks == 0)
+        return result;
+
+    task_numbers = malloc(sizeof(int) * num_tasks);
+    task_bins = malloc(sizeof(int) * num_tasks);
+    task_pmfs = malloc(sizeof(double *) * num_tasks);
+    pmfs = malloc(sizeof(pmf_struct *) * num_tasks);
+    for (crit_level = 0, j = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+    {
+        for (i = 0; i < index->num_tasks[crit_level]; i++, j++)
+        {
+            task_numbers[j] = index->task_list[crit_level][i];
+            curr_task = &(task_set->task_list[task_numbers[j]]);
+            pmfs[j] = find_task_pmf(curr_task, horizon);
+            task_pmfs[j] = malloc(sizeof(double) * MAX_PMF_BINS);
+            max_value = max(max_value, pmfs[j]->value[pmfs[j]->num_points - 1]);
+            num_jobs += max_int(0, (int)ceil((horizon - curr_task->phase) / curr_task->period));
+        }
+    }
+
+    //A job takes at most half of the lattice.
+    while (max_value / width >= MAX_PMF_BINS / 2)
+        width *= 2;
+    for (j = 0; j < num_tasks; j++)
+    {
+        task_bins[j] = discretize_pmf(pmfs[j], width, task_pmfs[j]);
+    }
+
+    //The jobs released before the horizon with their deadline, in increasing order of deadline.
+    jobs = malloc(sizeof(double) * 2 * max_int(1, num_jobs));
+    for (j = 0, num_jobs = 0; j < num_tasks; j++)
+    {
+        curr_task = &(task_set->task_list[task_numbers[j]]);
+        for (release = curr_task->phase; release < horizon; release += curr_task->period)
+        {
+            jobs[2 * num_jobs] = release + curr_task->relative_deadline;
+            jobs[2 * num_jobs + 1] = j;
+            num_jobs++;
+        }
+    }
+    qsort(jobs, num_jobs, 2 * sizeof(double), deadline_comparator);
+
+    demand = malloc(sizeof(double) * 2 * MAX_PMF_BINS);
+    demand[0] = 1.00;
+
+    for (i = 0; i < num_jobs; i++)
+    {
+        j = (int)jobs[2 * i + 1];
+
+        //Resample the lattice until the demand with the job fits in MAX_PMF_BINS bins.
+        while (num_bins + task_bins[j] - 1 > MAX_PMF_BINS)
+        {
+            width *= 2;
+            for (b = 1; 2 * b - 1 < num_bins; b++)
+            {
+                demand[b] = demand[2 * b - 1] + ((2 * b < num_bins) ? demand[2 * b] : 0.00);
+            }
+            num_bins = b;
+            for (b = 0; b < num_tasks; b++)
+            {
+                task_bins[b] = discretize_pmf(pmfs[b], width, task_pmfs[b]);
+            }
+        }
+
+        job_bins = task_bins[j];
+        num_bins = convolve_pmf(demand, num_bins, task_pmfs[j], job_bins);
+
+        //The demand is checked once all the jobs with the same deadline are added.
+        deadline = jobs[2 * i];
+        if (i + 1 < num_jobs && jobs[2 * (i + 1)] == deadline)
+            continue;
+
+        miss = 0.00;
+        for (b = num_bins - 1; b >= 0 && b * width > deadline + 1e-9; b--)
+        {
+            miss += demand[b];
+        }
+        result.deadline_miss = max(result.deadline_miss, min(1.00, miss));
+    }
+
+    for (j = 0; j < num_tasks; j++)
+    {
+        free_pmf(pmfs[j]);
+        free(task_pmfs[j]);
+    }
+    free(pmfs);
+    free(task_pmfs);
+    free(task_bins);
+    free(task_numbers);
+    free(jobs);
+    free(demand);
+
+    return result;
+}
@@ -15,53 +15,51 @@ job *find_job_list(double start_time, double end_time, task_set_struct *task_set
 {
     job *job_head = NULL, *new_job, *temp;
     int i;
+    task_table_struct *table = &(task_set->core_table[core_no]);
     double release_time;
-    task curr_task;
     int total_jobs = 0;
 
-    for (i = 0; i < task_set->total_tasks; i++)
+    for (i = table->level_start[curr_crit_level]; i < table->num_tasks; i++)
     {
-        if (task_set->task_list[i].criticality_lvl >= curr_crit_level && task_set->task_list[i].core == core_no)
+        release_time = table->phase[i] + table->period[i] * table->job_number[i];
+        while (release_time >= start_time && release_time < end_time)
         {
-            curr_task = task_set->task_list[i];
-            release_time = task_set->task_list[i].phase + task_set->task_list[i].period * task_set->task_list[i].job_number;
-            while (release_time >= start_time && release_time < end_time)
+            new_job = malloc(sizeof(job));
+            new_job->execution_time = table->WCET[i];
+            new_job->rem_exec_time = table->WCET[i];
+            new_job->release_time = release_time;
+            new_job->WCET_counter = table->WCET[i];
+            new_job->task_number = table->task_number[i];
+            new_job->job_task = &(task_set->task_list[table->task_number[i]]);
+            new_job->discarded = 0;
+            new_job->next = NULL;
+
+            if (job_head == NULL)
             {
-                new_job = malloc(sizeof(job));
-                new_job->execution_time = curr_task.WCET[curr_task.criticality_lvl];
-                new_job->rem_exec_time = curr_task.WCET[curr_task.criticality_lvl];
-                new_job->release_time = release_time;
-                new_job->task_number = i;
-                new_job->absolute_deadline = release_time + task_set->task_list[i].virtual_deadline;
-                new_job->next = NULL;
-
-                if (job_head == NULL)
+                job_head = new_job;
+            }
+            else
+            {
+                if (find_job_deadline(new_job) > find_job_deadline(job_head))
                 {
+                    new_job->next = job_head;
                     job_head = new_job;
                 }
                 else
                 {
-                    if (new_job->absolute_deadline > job_head->absolute_deadline)
-                    {
-                        new_job->next = job_head;
-                        job_head = new_job;
-                    }
-                    else
+                    temp = job_head;
+                    while (temp->next && find_job_deadline(temp->next) > find_job_deadline(new_job))
                     {
-                        temp = job_head;
-                        while (temp->next && temp->next->absolute_deadline > new_job->absolute_deadline)
-                        {
-                            temp = temp->next;
-                        }
-
-                        new_job->next = temp->next;
-                        temp->next = new_job;
+                        temp = temp->next;
                     }
-                }
 
-                release_time += task_set->task_list[i].period;
-                total_jobs++;
+                    new_job->next = temp->next;
+                    temp->next = new_job;
+                }
             }
+
+            release_time += table->period[i];
+            total_jobs++;
         }
     }
 
@@ -81,7 +79,8 @@ job *find_job_list(double start_time, double end_time, task_set_struct *task_set
 double find_procrastination_interval(double curr_time, task_set_struct *task_set, int curr_crit_level, int core_no)
 {
     double next_deadline1 = INT_MAX, next_deadline2 = INT_MIN;
-    int i, crit_level;
+    int i, job_number;
+    task_table_struct *table = &(task_set->core_table[core_no]);
     double release_time, absolute_deadline;
     double timer_expiry = 0, total_utilisation = 0;
     double earliest_task_WCET = 0;
@@ -89,20 +88,16 @@ double find_procrastination_interval(double curr_time, task_set_struct *task_set
 
     fprintf(output[core_no], "Finding procrastination interval:\n");
 
-    for (i = 0; i < task_set->total_tasks; i++)
+    //The tasks with criticality level >= current criticality level are the range [level_start[curr_crit_level], num_tasks) of the task table.
+    for (i = table->level_start[curr_crit_level]; i < table->num_tasks; i++)
     {
-        if (task_set->task_list[i].criticality_lvl >= curr_crit_level && task_set->task_list[i].core == core_no)
+        job_number = find_next_job_number(table, i, curr_time, 1);
+        release_time = table->phase[i] + table->period[i] * job_number;
+        absolute_deadline = release_time + table->virtual_deadline[i];
+        if (next_deadline1 > absolute_deadline && curr_time < absolute_deadline)
         {
-            int job_number = task_set->task_list[i].job_number;
-            while ((release_time = task_set->task_list[i].phase + task_set->task_list[i].period * job_number) < curr_time)
-                job_number++;
-            absolute_deadline = release_time + task_set->task_list[i].virtual_deadline;
-            crit_level = task_set->task_list[i].criticality_lvl;
-            if (next_deadline1 > absolute_deadline && curr_time < absolute_deadline)
-            {
-                next_deadline1 = absolute_deadline;
-                earliest_task_WCET = task_set->task_list[i].WCET[crit_level];
-            }
+            next_deadline1 = absolute_deadline;
+            earliest_task_WCET = table->WCET[i];
         }
     }
 
@@ -115,20 +110,14 @@ double find_procrastination_interval(double curr_time, task_set_struct *task_set
     }
 
     next_deadline2 = next_deadline1;
-    for (i = 0; i < task_set->total_tasks; i++)
+    for (i = table->level_start[curr_crit_level]; i < table->num_tasks; i++)
     {
-        if (task_set->task_list[i].criticality_lvl >= curr_crit_level && task_set->task_list[i].core == core_no)
+        job_number = find_next_job_number(table, i, next_deadline1, 0) - 1;
+        release_time = table->phase[i] + table->period[i] * job_number;
+        absolute_deadline = release_time + table->virtual_deadline[i];
+        if (next_deadline2 < absolute_deadline && release_time <= next_deadline1)
         {
-            int job_number = task_set->task_list[i].job_number;
-            while ((release_time = task_set->task_list[i].phase + task_set->task_list[i].period * job_number) <= next_deadline1)
-                job_number++;
-            job_number--;
-            release_time = task_set->task_list[i].phase + task_set->task_list[i].period * job_number;
-            absolute_deadline = release_time + task_set->task_list[i].virtual_deadline;
-            if (next_deadline2 < absolute_deadline && release_time <= next_deadline1)
-            {
-                next_deadline2 = absolute_deadline;
-            }
+            next_deadline2 = absolute_deadline;
         }
     }
 
@@ -140,12 +129,9 @@ double find_procrastination_interval(double curr_time, task_set_struct *task_set
 
     timer_expiry = next_deadline2;
 
-    for (i = 0; i < task_set->total_tasks; i++)
+    for (i = table->level_start[curr_crit_level]; i < table->num_tasks; i++)
     {
-        if (task_set->task_list[i].criticality_lvl >= curr_crit_level && task_set->task_list[i].core == core_no)
-        {
-            total_utilisation += task_set->task_list[i].util[curr_crit_level];
-        }
+        total_utilisation += table->util[i * MAX_CRITICALITY_LEVELS + curr_crit_level];
     }
 
     // total_utilisation = (double)((int)(total_utilisation * 100)) / 100;
@@ -154,7 +140,7 @@ double find_procrastination_interval(double curr_time, task_set_struct *task_set
     while (job_list != NULL)
     {
         fprintf(output[core_no], "Job: %d, Release time: %.5lf, Execution time: %.5lf, Total utilisation: %.5lf\n", job_list->task_number, job_list->release_time, job_list->execution_time, total_utilisation);
-        if (job_list->absolute_deadline > next_deadline2)
+        if (find_job_deadline(job_list) > next_deadline2)
         {
             timer_expiry -= ((next_deadline2 - job_list->release_time) * ((double)job_list->execution_time / (double)task_set->task_list[job_list->task_number].period) * total_utilisation);
             fprintf(output[core_no], "If statement\n");
@@ -165,9 +151,9 @@ double find_procrastination_interval(double curr_time, task_set_struct *task_set
             timer_expiry -= job_list->execution_time;
         }
 
-        if (job_list->next && timer_expiry > job_list->next->absolute_deadline)
+        if (job_list->next && timer_expiry > find_job_deadline(job_list->next))
         {
-            timer_expiry = job_list->next->absolute_deadline;
+            timer_expiry = find_job_deadline(job_list->next);
         }
 
         fprintf(output[core_no], "Time expiry: %.5lf\n", timer_expiry);
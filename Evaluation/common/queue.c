@@ -1,85 +1,279 @@
 #include "functions.h"
 
 /*
-    Preconditions: 
-        Input: {pointer to discarded job queue, pointer to discarded job, task list}
-                discarded_queue!=NULL
-                task_list!=NULL
-                new_job!=NULL
+    Preconditions:
+        Input: {void}
+                MAX_CRITICALITY_LEVELS is set.
 
-    Purpose of the function: Insert a new job in the discarded queue, sorted according to the deadline and the criticality level.
+    Purpose of the function: Creates an empty job queue, with one list of jobs for each criticality level.
 
     Postconditions:
-        Output: {null}
+        Output: {Pointer to the job queue}
 */
-void insert_job_in_discarded_queue(job_queue_struct **discarded_queue, job *new_job, task *task_list, int core_no)
+job_queue_struct *initialize_job_queue()
 {
-    job *temp;
+    job_queue_struct *queue = (job_queue_struct *)malloc(sizeof(job_queue_struct));
+
+    queue->num_jobs = 0;
+    queue->next_order = 0;
+    queue->mode_level = 0;
+    queue->ready_jobs = NULL;
+    queue->level_head = (job **)calloc(MAX_CRITICALITY_LEVELS, sizeof(job *));
+
+    return queue;
+}
 
-    if ((*discarded_queue)->num_jobs == 0)
+/*
+    Function to free a job queue and the jobs in it.
+*/
+void free_job_queue(job_queue_struct *queue)
+{
+    job *curr, *next;
+    int level;
+
+    for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
     {
-        (*discarded_queue)->job_list_head = new_job;
-        (*discarded_queue)->num_jobs++;
+        for (curr = queue->level_head[level]; curr != NULL; curr = next)
+        {
+            next = curr->next;
+            free(curr);
+        }
     }
-    else
+    free(queue->level_head);
+    free(queue);
+}
+
+/*
+    Function to find the deadline of a job: its release time plus the current virtual deadline of its task.
+*/
+double find_job_deadline(job *curr_job)
+{
+    return curr_job->release_time + curr_job->job_task->virtual_deadline;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the job, criticality level}
+                curr_job!=NULL
+
+    Purpose of the function: Brings the budget of the job (WCET_counter) from its budget_level up to the given level. The WCET of each level crossed is
+                             replaced by the WCET of the next level, as the criticality changes did when they updated every job.
+
+    Postconditions:
+        Output: {void}
+        Result: The budget of the job is counted at the given level.
+*/
+void update_job_budget(job *curr_job, int level)
+{
+    int crit_level;
+
+    for (crit_level = curr_job->budget_level + 1; crit_level <= level; crit_level++)
     {
-        if (task_list[new_job->task_number].criticality_lvl > task_list[(*discarded_queue)->job_list_head->task_number].criticality_lvl || (task_list[new_job->task_number].criticality_lvl == task_list[(*discarded_queue)->job_list_head->task_number].criticality_lvl && new_job->absolute_deadline < (*discarded_queue)->job_list_head->absolute_deadline))
+        curr_job->WCET_counter -= (curr_job->job_task->WCET[crit_level - 1]);
+        curr_job->WCET_counter += (curr_job->job_task->WCET[crit_level]);
+    }
+    curr_job->budget_level = level;
+}
+
+/*
+    Function to check whether job A comes before job B in the ready queue: A has the earlier deadline, or the same deadline and was inserted first.
+*/
+int precedes_job(job *A, job *B)
+{
+    double deadline_A = find_job_deadline(A), deadline_B = find_job_deadline(B);
+
+    return deadline_A < deadline_B || (deadline_A == deadline_B && A->queue_order < B->queue_order);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the job queue}
+                queue!=NULL
+
+    Purpose of the function: Finds the head of the ready queue, i.e., the earliest of the heads of the lists of the criticality levels.
+                             Ties between the levels go to the job inserted first, as in a single list sorted according to the deadlines.
+
+    Postconditions:
+        Output: {Pointer to the job with the earliest deadline, NULL if the queue is empty}
+*/
+job *find_earliest_job(job_queue_struct *queue)
+{
+    job *earliest = NULL;
+    int level;
+
+    for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
+    {
+        if (queue->level_head[level] != NULL && (earliest == NULL || precedes_job(queue->level_head[level], earliest)))
+            earliest = queue->level_head[level];
+    }
+
+    return earliest;
+}
+
+/*
+    Preconditions:
+        Input: {array of MAX_CRITICALITY_LEVELS positions in the lists of a ready queue}
+                The positions are initially the heads of the lists (level_head).
+
+    Purpose of the function: Traverses the ready queue in the order of the deadlines. The earliest job at the positions is returned and its position
+                             is moved to the next job of its level.
+
+    Postconditions:
+        Output: {Pointer to the next job of the ready queue, NULL after the last job}
+*/
+job *next_job_in_order(job **cursor)
+{
+    job *earliest = NULL;
+    int level, earliest_level = -1;
+
+    for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
+    {
+        if (cursor[level] != NULL && (earliest == NULL || precedes_job(cursor[level], earliest)))
         {
-            new_job->next = (*discarded_queue)->job_list_head;
-            (*discarded_queue)->job_list_head = new_job;
+            earliest = cursor[level];
+            earliest_level = level;
         }
-        else
-        {
-            temp = (*discarded_queue)->job_list_head;
+    }
+
+    if (earliest != NULL)
+        cursor[earliest_level] = earliest->next;
+
+    return earliest;
+}
+
+/*
+    Function to insert a job in a list sorted according to the deadlines. The job is inserted after the jobs with the same deadline.
+*/
+void insert_job_in_list(job **head, job *new_job)
+{
+    job *temp;
+    double deadline = find_job_deadline(new_job);
+
+    if (*head == NULL || deadline < find_job_deadline(*head))
+    {
+        new_job->next = *head;
+        *head = new_job;
+        return;
+    }
+
+    temp = *head;
+    while (temp->next != NULL && find_job_deadline(temp->next) <= deadline)
+    {
+        temp = temp->next;
+    }
+    new_job->next = temp->next;
+    temp->next = new_job;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to discarded job queue}
+                discarded_queue!=NULL
+
+    Purpose of the function: Keeps the discarded queue within discarded_capacity jobs (if it is set) and records its peak size.
+                             The jobs are evicted from the lowest criticality level first. Within a level, the evicted job is the least feasible one to readmit:
+                             the one with the least laxity (deadline minus remaining WCET), which has the least slack left to be executed in.
+
+    Postconditions:
+        Output: {void}
+        Result: The evicted jobs are freed. The peak size and the number of evicted jobs are updated in the statistics.
+*/
+void evict_discarded_jobs(job_queue_struct **discarded_queue)
+{
+    job **link, **evict_link, *evict_job;
+    double laxity, min_laxity;
+    int level;
+
+    while (discarded_capacity > 0 && (*discarded_queue)->num_jobs > discarded_capacity)
+    {
+        for (level = 0; (*discarded_queue)->level_head[level] == NULL; level++)
+            ;
 
-            while (temp && temp->next && (task_list[temp->next->task_number].criticality_lvl > task_list[new_job->task_number].criticality_lvl || (task_list[temp->next->task_number].criticality_lvl == task_list[new_job->task_number].criticality_lvl && temp->next->absolute_deadline <= new_job->absolute_deadline)))
+        evict_link = NULL;
+        min_laxity = 0.00;
+        for (link = &((*discarded_queue)->level_head[level]); *link != NULL; link = &((*link)->next))
+        {
+            laxity = find_job_deadline(*link) - ((*link)->job_task->WCET[(*link)->job_task->criticality_lvl] - ((*link)->execution_time - (*link)->rem_exec_time));
+            if (evict_link == NULL || laxity < min_laxity)
             {
-                temp = temp->next;
+                evict_link = link;
+                min_laxity = laxity;
             }
-            new_job->next = temp->next;
-            temp->next = new_job;
         }
-        (*discarded_queue)->num_jobs++;
+
+        evict_job = *evict_link;
+        *evict_link = evict_job->next;
+        (*discarded_queue)->num_jobs--;
+        stats->total_evicted_jobs++;
+        free(evict_job);
     }
+
+    stats->peak_discarded_jobs = max_int(stats->peak_discarded_jobs, (*discarded_queue)->num_jobs);
+
+    return;
 }
 
-void remove_jobs_from_discarded_queue(job_queue_struct **discarded_queue, double curr_time)
+/*
+    Preconditions:
+        Input: {pointer to discarded job queue, pointer to discarded job, task list}
+                discarded_queue!=NULL
+                task_list!=NULL
+                new_job!=NULL
+
+    Purpose of the function: Insert a new job in the discarded queue, sorted according to the deadline and the criticality level.
+                             The job is inserted in the list of its criticality level. If the discarded queue is full, a job is evicted from it (it may be the new job).
+
+    Postconditions:
+        Output: {null}
+*/
+void insert_job_in_discarded_queue(job_queue_struct **discarded_queue, job *new_job, task *task_list, int core_no)
 {
-    job *free_job, *prev, *curr, *dummy_node;
-    dummy_node = malloc(sizeof(job));
-    dummy_node->next = (*discarded_queue)->job_list_head;
-    dummy_node->task_number = -1;
-    dummy_node->job_number = -1;
+    insert_job_in_list(&((*discarded_queue)->level_head[new_job->criticality_lvl]), new_job);
+    (*discarded_queue)->num_jobs++;
+    evict_discarded_jobs(discarded_queue);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to discarded job queue, the current time}
+                discarded_queue!=NULL
 
-    prev = dummy_node;
-    curr = (*discarded_queue)->job_list_head;
+    Purpose of the function: Remove the jobs from the discarded queue whose deadlines have passed. The lists are sorted according to the deadlines,
+                             so these jobs are at the front of each list.
 
-    while(curr != NULL)
+    Postconditions:
+        Output: {void}
+        Result: The removed jobs are freed.
+*/
+void remove_jobs_from_discarded_queue(job_queue_struct **discarded_queue, double curr_time)
+{
+    job *free_job;
+    int level;
+
+    for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
     {
-        // printf("Prev: %d,%d. Curr: %d,%d\n", prev->task_number, prev->job_number, curr->task_number, curr->job_number);
-        if(curr->absolute_deadline <= curr_time)
+        while ((*discarded_queue)->level_head[level] != NULL && find_job_deadline((*discarded_queue)->level_head[level]) <= curr_time)
         {
-            free_job = curr;
-            prev->next = curr->next;
-            curr = curr->next;
+            free_job = (*discarded_queue)->level_head[level];
+            (*discarded_queue)->level_head[level] = free_job->next;
             free_job->next = NULL;
             (*discarded_queue)->num_jobs--;
-            // free(free_job);
-        }
-        else
-        {
-            prev = curr;
-            curr = curr->next;
+            free(free_job);
         }
     }
 
-    (*discarded_queue)->job_list_head = dummy_node->next;
-    dummy_node->next = NULL;
-    free(dummy_node);
-
     return;
 }
 
+/*
+    Function to add count to the running number of the ready jobs of the level of the job for the core of its task, if the ready queue keeps them (mode_return).
+*/
+void count_ready_job(job_queue_struct *ready_queue, job *curr_job, int count)
+{
+    if (ready_queue->ready_jobs != NULL)
+        ready_queue->ready_jobs[curr_job->job_task->core * MAX_CRITICALITY_LEVELS + curr_job->criticality_lvl] += count;
+}
+
 /*
     Preconditions:
         Input: {pointer to ready queue (passed by pointer), pointer to job to be inserted}
@@ -87,98 +281,166 @@ void remove_jobs_from_discarded_queue(job_queue_struct **discarded_queue, double
                 new_job!=NULL
 
     Purpose of the function: This function enters a new job in the ready queue in the appropriate location. The ready queue is sorted according to the deadlines.
-                            
-    Postconditions: 
+                             The job is inserted in the list of its criticality level. Its budget is counted at the level of the ready queue from now on.
+
+    Postconditions:
         Output: {void}
         Result: A new ready queue with the newly arrived job inserted in the correct position.
 */
 void insert_job_in_ready_queue(job_queue_struct **ready_queue, job *new_job)
 {
-    job *temp;
+    new_job->budget_level = (*ready_queue)->mode_level;
+    new_job->queue_order = (*ready_queue)->next_order++;
+    insert_job_in_list(&((*ready_queue)->level_head[new_job->criticality_lvl]), new_job);
+    (*ready_queue)->num_jobs++;
+    count_ready_job(*ready_queue, new_job, 1);
 
-    if ((*ready_queue)->num_jobs == 0)
-    {
-        (*ready_queue)->job_list_head = new_job;
-        (*ready_queue)->num_jobs = 1;
-    }
-    else
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the list of the discarded queue, list of jobs of the same level from a ready queue, level of the ready queue, core number}
+
+    Purpose of the function: Merges the jobs of one criticality level of a ready queue into the list of that level of the discarded queue, in one pass over both lists.
+                             The jobs from the ready queue come after the discarded jobs with the same deadline, as if they were inserted one by one.
+                             The budgets of the jobs are brought up to the level of the ready queue, and stay there while the jobs are discarded.
+
+    Postconditions:
+        Output: {The number of jobs merged}
+        Result: The remaining execution time of the jobs is added to the discarded work available on the core.
+*/
+int merge_jobs_in_discarded_list(job **discarded_head, job *ready_head, int mode_level, int core_no)
+{
+    job *merged = NULL, **tail = &merged;
+    int num_jobs = 0;
+
+    while (ready_head != NULL)
     {
-        if (new_job->absolute_deadline < (*ready_queue)->job_list_head->absolute_deadline)
+        if (*discarded_head != NULL && find_job_deadline(*discarded_head) <= find_job_deadline(ready_head))
         {
-            new_job->next = (*ready_queue)->job_list_head;
-            (*ready_queue)->job_list_head = new_job;
+            *tail = *discarded_head;
+            *discarded_head = (*discarded_head)->next;
         }
         else
         {
-
-            temp = (*ready_queue)->job_list_head;
-
-            while (temp->next != NULL && temp->next->absolute_deadline <= new_job->absolute_deadline)
-            {
-                temp = temp->next;
-            }
-            new_job->next = temp->next;
-            temp->next = new_job;
+            update_job_budget(ready_head, mode_level);
+            ready_head->discarded = 1;
+            stats->total_discarded_jobs_available[core_no] += ready_head->rem_exec_time;
+            *tail = ready_head;
+            ready_head = ready_head->next;
+            num_jobs++;
         }
-
-        (*ready_queue)->num_jobs++;
+        tail = &((*tail)->next);
     }
+    *tail = *discarded_head;
+    *discarded_head = merged;
 
-    return;
+    return num_jobs;
 }
 
 /*
     Preconditions:
-        Input: {pointer to the job queue, pointer to the taskset}
+        Input: {pointer to the job queue, pointer to the discarded queue, the new criticality level, whether the virtual deadlines of the core were reset, core number}
                 ready_queue!=NULL
-                task_list!=NULL
-    
+                discarded_queue!=NULL
+
     Purpose of the function: This function will remove all the low-criticality jobs from the ready queue.
+                             The list of each low criticality level is merged as a whole into the discarded queue. The high criticality jobs are not visited:
+                             their budgets follow the level of the ready queue, which the caller raises, and their deadlines follow the virtual deadlines of their tasks.
+                             Only when the virtual deadlines were just reset, the deadlines moved by different amounts and the queue is sorted again.
 
     Postconditions:
         Output: {void}
         Result: The job queue will now contain only high criticality jobs.
 */
-void remove_jobs_from_ready_queue(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task *task_list, int curr_crit_lvl, int k, int core_no)
+void remove_jobs_from_ready_queue(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, int curr_crit_lvl, int deadlines_reset, int core_no)
 {
-    job *free_job, *dummy_node, *prev, *curr;
-    dummy_node = malloc(sizeof(job));
-    dummy_node->task_number = -1;
-    dummy_node->job_number = -1;
-    dummy_node->next = (*ready_queue)->job_list_head;
-    prev = dummy_node;
-    curr = (*ready_queue)->job_list_head;
+    job *curr, *next, *remaining = NULL, **tail = &remaining, *cursor[MAX_CRITICALITY_LEVELS];
+    int level, num_jobs;
+
+    for (level = 0; level < curr_crit_lvl; level++)
+    {
+        for (curr = (*ready_queue)->level_head[level]; (*ready_queue)->ready_jobs != NULL && curr != NULL; curr = curr->next)
+            count_ready_job(*ready_queue, curr, -1);
+        num_jobs = merge_jobs_in_discarded_list(&((*discarded_queue)->level_head[level]), (*ready_queue)->level_head[level], (*ready_queue)->mode_level, core_no);
+        (*ready_queue)->level_head[level] = NULL;
+        (*ready_queue)->num_jobs -= num_jobs;
+        (*discarded_queue)->num_jobs += num_jobs;
+    }
+    evict_discarded_jobs(discarded_queue);
 
-    while(curr != NULL)
+    //The jobs are inserted again in their previous order (with the previous deadlines), so the jobs with the same new deadline keep their order.
+    if (deadlines_reset)
     {
-        // printf("Prev: %d,%d. Curr: %d,%d\n", prev->task_number, prev->job_number, curr->task_number, curr->job_number);
-        if(task_list[curr->task_number].criticality_lvl < curr_crit_lvl)
+        memcpy(cursor, (*ready_queue)->level_head, sizeof(job *) * MAX_CRITICALITY_LEVELS);
+        while ((curr = next_job_in_order(cursor)) != NULL)
         {
-            free_job = curr;
-            prev->next = curr->next;
-            curr = curr->next;
-            (*ready_queue)->num_jobs--;
-            free_job->next = NULL;
-            stats->total_discarded_jobs_available[core_no] += free_job->rem_exec_time;
-            insert_job_in_discarded_queue(discarded_queue, free_job, task_list, core_no);
+            *tail = curr;
+            tail = &(curr->next);
         }
-        else
+        *tail = NULL;
+
+        for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
+            (*ready_queue)->level_head[level] = NULL;
+        (*ready_queue)->num_jobs = 0;
+
+        for (curr = remaining; curr != NULL; curr = next)
         {
-            if(curr_crit_lvl > k)
+            next = curr->next;
+            curr->next = NULL;
+            update_job_budget(curr, (*ready_queue)->mode_level);
+            count_ready_job(*ready_queue, curr, -1);
+            insert_job_in_ready_queue(ready_queue, curr);
+        }
+    }
+
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to discarded job queue, core number, threshold level of the core}
+                discarded_queue!=NULL
+
+    Purpose of the function: Sorts the discarded queue again after the virtual deadlines of the core were set or reset again (after a criticality mode return).
+                             Only the deadlines of the jobs of the tasks of the core above its threshold level moved, so only these jobs are taken out of their lists
+                             and inserted again. The other jobs keep their order.
+
+    Postconditions:
+        Output: {void}
+*/
+void sort_discarded_jobs(job_queue_struct **discarded_queue, int core_no, int threshold_crit_lvl)
+{
+    job **link, *moved, **tail, *curr, *next;
+    int level;
+
+    for (level = threshold_crit_lvl + 1; level < MAX_CRITICALITY_LEVELS; level++)
+    {
+        moved = NULL;
+        tail = &moved;
+        link = &((*discarded_queue)->level_head[level]);
+        while (*link != NULL)
+        {
+            curr = *link;
+            if (curr->job_task->core == core_no)
             {
-                curr->absolute_deadline -= task_list[curr->task_number].virtual_deadline;
-                curr->absolute_deadline += task_list[curr->task_number].relative_deadline;
+                *link = curr->next;
+                *tail = curr;
+                tail = &(curr->next);
             }
-            curr->WCET_counter -= (task_list[curr->task_number].WCET[curr_crit_lvl - 1]);
-            curr->WCET_counter += (task_list[curr->task_number].WCET[curr_crit_lvl]);
-            prev = curr;
-            curr = curr->next;
+            else
+                link = &(curr->next);
         }
-    }
+        *tail = NULL;
 
-    (*ready_queue)->job_list_head = dummy_node->next;
-    dummy_node->next = NULL;
-    free(dummy_node);
+        for (curr = moved; curr != NULL; curr = next)
+        {
+            next = curr->next;
+            curr->next = NULL;
+            insert_job_in_list(&((*discarded_queue)->level_head[level]), curr);
+        }
+    }
 
     return;
-}
\ No newline at end of file
+}
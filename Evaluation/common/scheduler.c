@@ -0,0 +1,674 @@
+#include "functions.h"
+
+/*
+    Preconditions:
+        Input: {pointer to the convergence state, pointer to processor}
+
+    Purpose of the function: Ends the current window of a windowed simulation. Each metric is a ratio of totals of the cores (active, idle or shutdown time
+                             over the total time, executed over available execution time of discarded jobs), estimated from the windows as R = sum(x) / sum(y),
+                             where x and y are the numerator and denominator in each window. The windows are treated as independent samples (batch means); the
+                             standard deviation s of x - R * y gives the confidence that R is within the tolerance of the mean as
+                             erf(tolerance * sqrt(n) * mean(y) / (s * sqrt(2))) for n windows.
+
+    Postconditions:
+        Output: {1 if all the metrics have converged (at least CONVERGENCE_MIN_WINDOWS windows and confidence >= CONVERGENCE_CONFIDENCE), else 0}
+        Result: The window is added to the convergence state and convergence->confidence is updated.
+*/
+static int check_convergence(convergence_struct *convergence, processor_struct *processor)
+{
+    double totals[NUM_METRICS + 1] = {0.00}, delta[NUM_METRICS + 1], x, y, ratio, deviation, confidence;
+    int num_core, i, n;
+
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        totals[0] += stats->total_active_energy[num_core];
+        totals[1] += stats->total_idle_energy[num_core];
+        totals[2] += stats->total_shutdown_time[num_core];
+        totals[3] += stats->total_discarded_jobs_executed[num_core];
+        totals[4] += stats->total_discarded_jobs_available[num_core];
+    }
+    for (i = 0; i <= NUM_METRICS; i++)
+    {
+        delta[i] = totals[i] - convergence->last[i];
+        convergence->last[i] = totals[i];
+    }
+    n = ++convergence->num_windows;
+
+    convergence->confidence = 1.00;
+    for (i = 0; i < NUM_METRICS; i++)
+    {
+        x = delta[i];
+        y = (i < 3) ? delta[0] + delta[1] + delta[2] : delta[4];
+        convergence->sum_x[i] += x;
+        convergence->sum_y[i] += y;
+        convergence->sum_xx[i] += x * x;
+        convergence->sum_xy[i] += x * y;
+        convergence->sum_yy[i] += y * y;
+
+        //A metric which is not defined yet (no discarded jobs) does not delay the convergence.
+        if (n < 2 || convergence->sum_y[i] <= 0.00)
+            continue;
+
+        ratio = convergence->sum_x[i] / convergence->sum_y[i];
+        deviation = sqrt(max(0.00, (convergence->sum_xx[i] - 2 * ratio * convergence->sum_xy[i] + ratio * ratio * convergence->sum_yy[i]) / (n - 1)));
+        confidence = (deviation > 0.00) ? erf(convergence_tolerance * sqrt(n) * (convergence->sum_y[i] / n) / (deviation * sqrt(2.00))) : 1.00;
+        convergence->confidence = min(convergence->confidence, confidence);
+    }
+
+    return (n >= CONVERGENCE_MIN_WINDOWS && convergence->confidence >= CONVERGENCE_CONFIDENCE);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, pointer to the discarded queue, the core which completed a job, the current time}
+                processor->ready_jobs!=NULL
+
+    Purpose of the function: Lowers the criticality level after a job completes on the core, to the highest criticality level of the ready jobs of the tasks
+                             of the core, or of the tasks of all the cores unless per_core_mode is set. At an idle instant (no jobs left) it is the lowest level.
+                             The jobs of the tasks of the core readmitted on other cores are counted, since their deadlines follow the virtual deadlines of the core.
+                             The highest level is found from the running numbers of the ready jobs (processor->ready_jobs), without walking the ready queues.
+                             The jobs left are not visited: the levels of the jobs of the lowered cores are at most the new level, so their deadlines do not move,
+                             and their budgets stay at the levels they were counted at.
+                             A core back at or below its threshold level sets the virtual deadlines of its tasks again, and its discarded jobs whose deadlines moved are
+                             sorted again in the discarded queue. The tasks from the new level on are admitted to the ready queue again from their next arrivals.
+
+    Postconditions:
+        Output: {1 if the level of any core was lowered, else 0}
+*/
+static int return_criticality_mode(task_set_struct *task_set, processor_struct *processor, job_queue_struct **discarded_queue, int core_no, double curr_time)
+{
+    core_struct *core;
+    int num_core, crit_level, level = 0, lowered = 0;
+
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        if (per_core_mode && num_core != core_no)
+            continue;
+        for (crit_level = MAX_CRITICALITY_LEVELS - 1; crit_level > level && processor->ready_jobs[num_core * MAX_CRITICALITY_LEVELS + crit_level] == 0; crit_level--)
+            ;
+        level = crit_level;
+    }
+
+    processor->crit_level = 0;
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        core = &(processor->cores[num_core]);
+        if ((!per_core_mode || num_core == core_no) && core->crit_level > level)
+        {
+            fprintf(output[num_core], "Criticality returned | Crit level: %d\n", level);
+            if (core->crit_level > core->threshold_crit_lvl && level <= core->threshold_crit_lvl)
+            {
+                set_virtual_deadlines(&task_set, num_core, core->x_factor, core->threshold_crit_lvl);
+                sort_discarded_jobs(discarded_queue, num_core, core->threshold_crit_lvl);
+            }
+            if (level == 0)
+                stats->total_raised_time[num_core] += curr_time - core->mode_switch_time;
+            stats->total_mode_returns[num_core]++;
+
+            core->crit_level = level;
+            core->ready_queue->mode_level = level;
+            lowered = 1;
+        }
+        processor->crit_level = max_int(processor->crit_level, core->crit_level);
+    }
+
+    return lowered;
+}
+
+/*
+    Preconditions: 
+        Input: {pointer to taskset, pointer to processor, algorithm (DPS, EDF_VD, EDF_VD_DJ or EDF)}
+
+    Purpose of the function: This function performs the scheduling of the taskset according to edf-vd. 
+                             The scheduling will be done for superhyperperiod of the tasks (or up to simulation_horizon, if it is set).
+                             A job queue will contain the jobs which have arrived at the current time unit, sorted according to their virtual deadlines. 
+                             The core will always take the head of the queue for scheduling.
+                             If convergence_window is set, the simulation is checked at the end of each window (check_convergence) and stops at the end of the
+                             first window at which the metrics have converged.
+                             If any job exceeds its WCET, a counter will indicate the same and the core's criticality level will change.
+                             At that time, all the LOW criticality jobs will be removed from the ready queue and only HIGH criticality jobs will be scheduled from now on.
+                             All the cores change their criticality level together, unless per_core_mode is set, in which case only the core of the job does and the
+                             other cores keep executing their LOW criticality jobs. If mode_return is set, the level is lowered again when a job completes
+                             (return_criticality_mode). If no core has a job, the idle and shutdown time of all the cores up to the next decision points is
+                             accounted at once (fast_forward_idle_cores). If mode_check is set, the levels of the cores are checked after each change (check_core_modes).
+                             The algorithms differ in the following:
+                                DPS and EDF procrastinate: an idle core is shutdown if the procrastination interval is large enough, and woken up by TIMER_EXPIRE.
+                                DPS and EDF_VD_DJ accommodate discarded jobs when a core becomes idle and after a criticality change. If discarded_migration is set,
+                                they also place a discarded job at once on another core with enough slack, using the slack index updated at each decision point.
+                                EDF (single criticality level) does not handle criticality changes.
+
+    Postconditions:
+        Return value: {void}
+        Output: The output will be stored in the output file. Each line will give the information about:
+                The type of decision point, 
+                core's total execution time, core's current criticality level, The currently executing job, its total execution time, its actual execution time and its absolute deadline.
+*/
+void schedule_taskset(task_set_struct *task_set, processor_struct *processor, int algo)
+{
+
+    double super_hyperperiod, decision_time, prev_decision_time;
+    decision_struct decision, pending[NUM_CORES];
+    convergence_struct convergence = {0};
+    int decision_point = ARRIVAL, decision_core = 0, num_core, level, converged = 0, num_pending = 0, next_pending = 0, mode_returned = 0, idle_batch = 0;
+
+    int procrastination = (algo == DPS || algo == EDF);
+    int accommodation = (algo == DPS || algo == EDF_VD_DJ);
+
+    job_queue_struct *discarded_queue;
+    job *curr;
+    discarded_queue = initialize_job_queue();
+
+    //The slack index is kept only if the discarded jobs are migrated between the cores.
+    processor->slack_index = NULL;
+    if (discarded_migration && accommodation)
+    {
+        processor->slack_index = initialize_slack_index(processor);
+        for (num_core = 0; num_core < processor->total_cores; num_core++)
+            update_slack_index(processor, task_set, num_core);
+    }
+
+    //The running numbers of the ready jobs of each level are kept only if the criticality level returns.
+    processor->ready_jobs = NULL;
+    if (mode_return && algo != EDF)
+    {
+        processor->ready_jobs = calloc(processor->total_cores * MAX_CRITICALITY_LEVELS, sizeof(int));
+        for (num_core = 0; num_core < processor->total_cores; num_core++)
+        {
+            processor->cores[num_core].ready_queue->ready_jobs = processor->ready_jobs;
+            for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
+            {
+                for (curr = processor->cores[num_core].ready_queue->level_head[level]; curr != NULL; curr = curr->next)
+                    count_ready_job(processor->cores[num_core].ready_queue, curr, 1);
+            }
+        }
+    }
+
+    //Find the hyperperiod of all the cores. The scheduler will run for the max of all hyperperiods.
+    super_hyperperiod = find_superhyperperiod(task_set);
+    //A truncated simulation (used by the allocation optimizer and the sweep) stops at the simulation horizon.
+    if (simulation_horizon > 0.00)
+        super_hyperperiod = min(super_hyperperiod, simulation_horizon);
+    fprintf(output_file, "Super hyperperiod: %.5lf\n", super_hyperperiod);
+    convergence.next_window = convergence_window;
+
+    while (1)
+    {
+        //Find the decision point. The decision point will be the minimum of the earliest arrival job, the completion of the currently executing job and the WCET counter for criticality change.
+        //The decision points of all the cores at the earliest time are found in one sweep and handled one after the other. The core just handled may have a new
+        //decision point at the same time, which comes before the next cores of the batch. A criticality change (or return) moves the decision points of all the cores.
+        if (next_pending < num_pending && decision_point != CRIT_CHANGE && !mode_returned)
+        {
+            decision = find_core_decision_point(task_set, processor, decision_core);
+            if (decision.decision_time > pending[next_pending].decision_time)
+                decision = pending[next_pending++];
+        }
+        else
+        {
+            num_pending = find_decision_points(task_set, processor, pending);
+            next_pending = 1;
+            decision = pending[0];
+            //If no core has a job, the processor is fast-forwarded to the batch (the next wake-ups and releases of all the cores).
+            idle_batch = check_all_cores(processor);
+        }
+        decision_point = decision.decision_point;
+        decision_time = decision.decision_time;
+        decision_core = decision.core_no;
+        mode_returned = 0;
+
+        //The decision points before the end of the window have been handled. Windows without decision points are merged with the next one.
+        if (convergence_window > 0.00 && decision_time >= convergence.next_window && convergence.next_window < super_hyperperiod)
+        {
+            if (check_convergence(&convergence, processor))
+            {
+                converged = 1;
+                fprintf(output_file, "Converged after %d windows at time %.5lf, confidence: %.5lf\n", convergence.num_windows, convergence.next_window, convergence.confidence);
+                super_hyperperiod = convergence.next_window;
+            }
+            convergence.next_window = (floor(decision_time / convergence_window) + 1) * convergence_window;
+        }
+
+        if (decision_time >= super_hyperperiod)
+        {
+            for (num_core = 0; num_core < processor->total_cores; num_core++)
+            {
+                if (processor->cores[num_core].state == SHUTDOWN)
+                {
+                    processor->cores[num_core].total_idle_time += (super_hyperperiod - processor->cores[num_core].total_time);
+                    stats->total_shutdown_time[num_core] += (super_hyperperiod - processor->cores[num_core].total_time);
+                }
+                else if (processor->cores[num_core].curr_exec_job == NULL) 
+                {
+                    processor->cores[num_core].total_idle_time += (super_hyperperiod - processor->cores[num_core].total_time);
+                    stats->total_idle_energy[num_core] += (super_hyperperiod - processor->cores[num_core].total_time);
+                }
+                else
+                {
+                    processor->cores[num_core].curr_exec_job->rem_exec_time -= (super_hyperperiod - processor->cores[num_core].total_time);
+                    stats->total_active_energy[num_core] += (super_hyperperiod - processor->cores[num_core].total_time);
+                }
+                processor->cores[num_core].total_time = super_hyperperiod;
+                update_job_arrivals(&(processor->cores[num_core].ready_queue), &discarded_queue, task_set, processor->cores[num_core].crit_level, processor->cores[num_core].total_time, num_core, processor, algo, 0);
+            }
+            if (convergence_window > 0.00 && !converged)
+                fprintf(output_file, "Not converged after %d windows, confidence: %.5lf\n", convergence.num_windows, convergence.confidence);
+            break;
+        }
+
+        //The idle and shutdown time of all the cores up to the batch is accounted at once, after the convergence window which ends before it.
+        if (idle_batch)
+        {
+            fast_forward_idle_cores(processor, decision_time);
+            idle_batch = 0;
+        }
+
+        fprintf(output[decision_core], "Decision point: %s, Decision time: %.5lf, Crit level: %d\n", decision_point == ARRIVAL ? "ARRIVAL" : ((decision_point == COMPLETION) ? "COMPLETION" : (decision_point == TIMER_EXPIRE && procrastination ? "TIMER EXPIRE" : "CRIT_CHANGE")), decision_time, processor->cores[decision_core].crit_level);
+
+        switch (decision_point)
+        {
+        case ARRIVAL:
+            stats->total_arrival_points[decision_core]++;
+            break;
+        case COMPLETION:
+            stats->total_completion_points[decision_core]++;
+            break;
+        case TIMER_EXPIRE:
+            if (procrastination)
+                stats->total_wakeup_points[decision_core]++;
+            break;
+        case CRIT_CHANGE:
+            stats->total_criticality_change_points[decision_core]++;
+            break;
+        }
+
+        //Remove the jobs from discarded queue that have missed their deadlines.
+        remove_jobs_from_discarded_queue(&discarded_queue, decision_time);
+
+        //Store the previous decision time of core for any further use.
+        prev_decision_time = processor->cores[decision_core].total_time;
+        //Update the total time of the core.
+        processor->cores[decision_core].total_time = decision_time;
+
+        //If the decision point is due to arrival of a job
+        if (decision_point == ARRIVAL)
+        {
+            //If the currently executing job in the core is NULL, then schedule a new job from the ready queue.
+            if (processor->cores[decision_core].curr_exec_job == NULL)
+            {
+                stats->total_idle_energy[decision_core] += (decision_time - prev_decision_time);
+                processor->cores[decision_core].total_idle_time += (decision_time - prev_decision_time);
+            }
+            else
+            {
+                stats->total_active_energy[decision_core] += (decision_time - prev_decision_time);
+                //Update the time for which the job has executed in the core and the WCET counter of the job.
+                double exec_time = processor->cores[decision_core].total_time - prev_decision_time;
+                processor->cores[decision_core].curr_exec_job->rem_exec_time -= exec_time;
+                processor->cores[decision_core].curr_exec_job->WCET_counter -= exec_time;
+            }
+
+            //Update the newly arrived jobs in the ready queue. Discarded jobs can be inserted in ready queue or discarded queue depeneding on the maximum slack available.
+            update_job_arrivals(&(processor->cores[decision_core].ready_queue), &discarded_queue, task_set, processor->cores[decision_core].crit_level, decision_time, decision_core, processor, algo, 0);
+
+            //If the currently executing job is not the head of the ready queue, then a job with earlier deadline has arrived.
+            //Preempt the current job and schedule the new job for execution.
+            if (compare_jobs(processor->cores[decision_core].curr_exec_job, find_earliest_job(processor->cores[decision_core].ready_queue)) == 0)
+            {
+                if (processor->cores[decision_core].curr_exec_job != NULL)
+                {
+                    fprintf(output[decision_core], "Preempt current job | ");
+                }
+                if (processor->cores[decision_core].ready_queue->num_jobs != 0)
+                {
+                    schedule_new_job(&(processor->cores[decision_core]), processor->cores[decision_core].ready_queue, task_set);
+                }
+                stats->total_context_switches[decision_core]++;
+            }
+        }
+
+        //If the decision point was due to completion of the currently executing job.
+        else if (decision_point == COMPLETION)
+        {
+            double procrastination_interval;
+            fprintf(output[decision_core], "Job %d, %d completed execution | ", processor->cores[decision_core].curr_exec_job->task_number, processor->cores[decision_core].curr_exec_job->job_number);
+
+            //Check to see if the job has missed its deadline or not. Virtual deadlines are not integral, so the times are compared with the tolerance of the schedulability tests.
+            double deadline = find_job_deadline(processor->cores[decision_core].curr_exec_job);
+            if (deadline < processor->cores[decision_core].total_time - 1e-9)
+            {
+                fprintf(output[decision_core], "Deadline missed. Completing scheduling\n");
+                processor->cores[decision_core].curr_exec_job = NULL;
+                break;
+            }
+
+            if(accommodation && processor->cores[decision_core].curr_exec_job->discarded) {
+                stats->total_discarded_jobs_executed[decision_core] += (decision_time - prev_decision_time);
+            }
+
+            processor->cores[decision_core].curr_exec_job = NULL;
+            //Remove the completed job from the ready queue.
+            update_job_removal(task_set, &(processor->cores[decision_core].ready_queue));
+
+            stats->total_active_energy[decision_core] += (decision_time - prev_decision_time);
+
+            //The criticality level returns to the highest level of the jobs left in the ready queues.
+            if (processor->ready_jobs != NULL && return_criticality_mode(task_set, processor, &discarded_queue, decision_core, decision_time))
+            {
+                mode_returned = 1;
+                if (mode_check)
+                    check_core_modes(processor, task_set);
+            }
+
+            //If ready queue is null, no job is ready for execution. Put the processor to sleep and find the next invocation time of processor.
+            if (processor->cores[decision_core].ready_queue->num_jobs == 0 && procrastination)
+            {
+                procrastination_interval = find_procrastination_interval(processor->cores[decision_core].total_time, task_set, processor->cores[decision_core].crit_level, decision_core);
+                fprintf(output[decision_core], "Procrastination interval: %.2lf | ", procrastination_interval);
+                if ((algo == DPS && procrastination_interval >= SHUTDOWN_THRESHOLD) || (algo == EDF && procrastination_interval > SHUTDOWN_THRESHOLD))
+                {
+                    fprintf(output[decision_core], "Putting core to sleep\n");
+                    processor->cores[decision_core].state = SHUTDOWN;
+                    processor->cores[decision_core].next_invocation_time = procrastination_interval + processor->cores[decision_core].total_time;
+                }
+                else
+                {
+                    fprintf(output[decision_core], "Not putting core to sleep\n");
+                    processor->cores[decision_core].state = ACTIVE;
+
+                    //Accommodate discarded jobs in ready queue.
+                    if (accommodation)
+                    {
+                        accommodate_discarded_jobs(&(processor->cores[decision_core].ready_queue), &discarded_queue, task_set, decision_core, processor->cores[decision_core].crit_level, processor->cores[decision_core].total_time);
+                        if (processor->cores[decision_core].ready_queue->num_jobs != 0)
+                        {
+                            schedule_new_job(&(processor->cores[decision_core]), processor->cores[decision_core].ready_queue, task_set);
+                        }
+                    }
+                }
+            }
+            else if (processor->cores[decision_core].ready_queue->num_jobs == 0)
+            {
+                processor->cores[decision_core].state = ACTIVE;
+
+                //Accommodate discarded jobs in ready queue.
+                if (accommodation)
+                {
+                    accommodate_discarded_jobs(&(processor->cores[decision_core].ready_queue), &discarded_queue, task_set, decision_core, processor->cores[decision_core].crit_level, processor->cores[decision_core].total_time);
+                }
+                if (processor->cores[decision_core].ready_queue->num_jobs != 0)
+                {
+                    schedule_new_job(&(processor->cores[decision_core]), processor->cores[decision_core].ready_queue, task_set);
+                }
+                else
+                {
+                    fprintf(output[decision_core], "No job to execute. Core is idle\n");
+                }
+            }
+            else
+            {
+                stats->total_context_switches[decision_core]++;
+                schedule_new_job(&(processor->cores[decision_core]), processor->cores[decision_core].ready_queue, task_set);
+            }
+        }
+
+        //If the decision point is due to timer expiry, wakeup the processor and schedule a new job from the ready queue.
+        else if (decision_point == TIMER_EXPIRE && procrastination)
+        {
+            //Wakeup the core and schedule the high priority process.
+            processor->cores[decision_core].state = ACTIVE;
+            processor->cores[decision_core].total_idle_time += (decision_time - prev_decision_time);
+            stats->total_shutdown_time[decision_core] += (decision_time - prev_decision_time);
+
+            fprintf(output[decision_core], "Timer expired. Waking up scheduler\n");
+
+            update_job_arrivals(&(processor->cores[decision_core].ready_queue), &discarded_queue, task_set, processor->cores[decision_core].crit_level, processor->cores[decision_core].total_time, decision_core, processor, algo, 1);
+
+            if (processor->cores[decision_core].ready_queue->num_jobs != 0)
+            {
+                stats->total_context_switches[decision_core]++;
+                schedule_new_job(&(processor->cores[decision_core]), processor->cores[decision_core].ready_queue, task_set);
+            }
+            else
+            {
+                double procrastination_interval = find_procrastination_interval(processor->cores[decision_core].total_time, task_set, processor->cores[decision_core].crit_level, decision_core);
+                fprintf(output[decision_core], (algo == EDF) ? "Procrastination interval: %.2lf\n" : "Procrastination interval: %.2lf | ", procrastination_interval);
+                if (procrastination_interval > SHUTDOWN_THRESHOLD)
+                {
+                    fprintf(output[decision_core], "Putting core to sleep again\n");
+                    processor->cores[decision_core].state = SHUTDOWN;
+                    processor->cores[decision_core].next_invocation_time = procrastination_interval + processor->cores[decision_core].total_time;
+                }
+                else
+                {
+                    fprintf(output[decision_core], "Not putting core to sleep\n");
+                    if (accommodation)
+                    {
+                        accommodate_discarded_jobs(&(processor->cores[decision_core].ready_queue), &discarded_queue, task_set, decision_core, processor->cores[decision_core].crit_level, processor->cores[decision_core].total_time);
+                        if (processor->cores[decision_core].ready_queue->num_jobs != 0)
+                        {
+                            schedule_new_job(&(processor->cores[decision_core]), processor->cores[decision_core].ready_queue, task_set);
+                        }
+                    }
+                }
+            }
+        }
+
+        //If decision point is due to criticality change, then the currently executing job has exceeded its WCET.
+        else if (decision_point == CRIT_CHANGE && algo != EDF)
+        {
+            double core_prev_decision_time;
+            int deadlines_reset;
+            //Increase the criticality level of the core whose job overran its WCET counter, or of all the cores unless per_core_mode is set.
+            //The level of the processor is the highest level of the cores.
+            for (num_core = 0; num_core < processor->total_cores; num_core++)
+            {
+                if ((per_core_mode && num_core != decision_core) || processor->cores[num_core].crit_level == MAX_CRITICALITY_LEVELS - 1)
+                    continue;
+                if (processor->cores[num_core].crit_level == 0)
+                    processor->cores[num_core].mode_switch_time = decision_time;
+                processor->cores[num_core].crit_level++;
+                stats->total_mode_switches[num_core]++;
+                processor->crit_level = max_int(processor->crit_level, processor->cores[num_core].crit_level);
+            }
+
+            //Remove all the low criticality jobs from the ready queue of each core whose level was raised and reset the virtual deadlines of high criticality jobs.
+            for (num_core = 0; num_core < processor->total_cores; num_core++)
+            {
+                if (per_core_mode && num_core != decision_core)
+                    continue;
+
+                deadlines_reset = 0;
+                if (processor->cores[num_core].crit_level > processor->cores[num_core].threshold_crit_lvl)
+                    deadlines_reset = reset_virtual_deadlines(&task_set, num_core, processor->cores[num_core].threshold_crit_lvl);
+                //The discarded jobs of the tasks of the core left from before a criticality return moved with the virtual deadlines.
+                if (deadlines_reset)
+                    sort_discarded_jobs(&discarded_queue, num_core, processor->cores[num_core].threshold_crit_lvl);
+
+                fprintf(output[num_core], "Criticality changed | Crit level: %d\n", processor->cores[num_core].crit_level);
+
+                if (processor->cores[num_core].state == ACTIVE)
+                {
+                    //Need the core's prevision decision time for updating the execution time of currently executing job.
+                    if (num_core != decision_core)
+                        core_prev_decision_time = processor->cores[num_core].total_time;
+                    else
+                        core_prev_decision_time = prev_decision_time;
+                    processor->cores[num_core].total_time = decision_time;
+
+                    //Update the time for which the current job has executed.
+                    if (processor->cores[num_core].curr_exec_job != NULL)
+                    {
+                        processor->cores[num_core].curr_exec_job->rem_exec_time -= (processor->cores[num_core].total_time - core_prev_decision_time);
+                        processor->cores[num_core].curr_exec_job->WCET_counter -= (processor->cores[num_core].total_time - core_prev_decision_time);
+
+                        stats->total_active_energy[num_core] += (processor->cores[num_core].total_time - core_prev_decision_time);
+                    }
+                    else
+                    {
+                        processor->cores[num_core].total_idle_time += (processor->cores[num_core].total_time - core_prev_decision_time);
+                        stats->total_idle_energy[num_core] += (processor->cores[num_core].total_time - core_prev_decision_time);
+                    }
+                    processor->cores[num_core].curr_exec_job = NULL;
+
+                    //First remove the low criticality jobs from ready queue and insert it into discarded queue.
+                    if (processor->cores[num_core].ready_queue->num_jobs != 0)
+                    {
+                        remove_jobs_from_ready_queue(&processor->cores[num_core].ready_queue, &discarded_queue, processor->cores[num_core].crit_level, deadlines_reset, num_core);
+                    }
+                    //The budgets of the remaining jobs (and of the jobs inserted from now on) are counted at the new criticality level.
+                    processor->cores[num_core].ready_queue->mode_level = processor->cores[num_core].crit_level;
+
+                    //Then try to accommodate the discarded jobs back in the ready queue.
+                    if (accommodation)
+                        accommodate_discarded_jobs(&(processor->cores[num_core].ready_queue), &discarded_queue, task_set, num_core, processor->cores[num_core].crit_level, processor->cores[num_core].total_time);
+
+                    if (processor->cores[num_core].ready_queue->num_jobs != 0)
+                    {
+                        stats->total_context_switches[num_core]++;
+                        schedule_new_job(&processor->cores[num_core], processor->cores[num_core].ready_queue, task_set);
+                        if(num_core != decision_core)
+                            fprintf(output[num_core], "Scheduled job: %d,%d  Exec time: %.5lf  Rem exec time: %.5lf  WCET_counter: %.5lf  Deadline: %.5lf\n",
+                                processor->cores[num_core].curr_exec_job->task_number,
+                                processor->cores[num_core].curr_exec_job->job_number,
+                                processor->cores[num_core].curr_exec_job->execution_time,
+                                processor->cores[num_core].curr_exec_job->rem_exec_time,
+                                processor->cores[num_core].WCET_counter,
+                                find_job_deadline(processor->cores[num_core].curr_exec_job));
+                    }
+                }
+                else
+                    processor->cores[num_core].ready_queue->mode_level = processor->cores[num_core].crit_level;
+            }
+            if (mode_check)
+                check_core_modes(processor, task_set);
+        }
+
+        //Each core updates its entry in the slack index at its decision points (all the cores after a criticality change or return).
+        if (processor->slack_index != NULL)
+        {
+            for (num_core = 0; num_core < processor->total_cores; num_core++)
+            {
+                if (num_core == decision_core || decision_point == CRIT_CHANGE || mode_returned)
+                    update_slack_index(processor, task_set, num_core);
+            }
+        }
+
+        if (processor->cores[decision_core].curr_exec_job != NULL)
+        {
+            fprintf(output[decision_core], "Scheduled job: %d,%d  Exec time: %.5lf  Rem exec time: %.5lf  WCET_counter: %.5lf  Deadline: %.5lf\n",
+                    processor->cores[decision_core].curr_exec_job->task_number,
+                    processor->cores[decision_core].curr_exec_job->job_number,
+                    processor->cores[decision_core].curr_exec_job->execution_time,
+                    processor->cores[decision_core].curr_exec_job->rem_exec_time,
+                    processor->cores[decision_core].WCET_counter,
+                    find_job_deadline(processor->cores[decision_core].curr_exec_job));
+        }
+        // fprintf(output[decision_core], "Core: %d, Total time: %.5lf, Total idle time: %.5lf\n", decision_core, processor->cores[decision_core].total_time, processor->cores[decision_core].total_idle_time);
+        fprintf(output[decision_core], "\n");
+        fprintf(output[decision_core], "____________________________________________________________________________________________________\n\n");
+    }
+    if (processor->slack_index != NULL)
+    {
+        free_slack_index(processor->slack_index);
+        processor->slack_index = NULL;
+    }
+    if (processor->ready_jobs != NULL)
+    {
+        for (num_core = 0; num_core < processor->total_cores; num_core++)
+            processor->cores[num_core].ready_queue->ready_jobs = NULL;
+        free(processor->ready_jobs);
+        processor->ready_jobs = NULL;
+    }
+
+    fprintf(output_file, "Discarded queue: peak size: %d, evicted jobs: %d\n", stats->peak_discarded_jobs, stats->total_evicted_jobs);
+    //The scheduling ends at the super hyperperiod, or earlier at a deadline miss.
+    for (num_core = 0; num_core < processor->total_cores && algo != EDF; num_core++)
+    {
+        if (processor->cores[num_core].crit_level > 0)
+            stats->total_raised_time[num_core] += min(decision_time, super_hyperperiod) - processor->cores[num_core].mode_switch_time;
+        fprintf(output_file, "Core %d: crit level: %d, mode switches: %d, mode returns: %d, time above the lowest level: %.5lf\n", num_core, processor->cores[num_core].crit_level,
+                stats->total_mode_switches[num_core], stats->total_mode_returns[num_core], stats->total_raised_time[num_core]);
+    }
+    free_job_queue(discarded_queue);
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {number of arguments, arguments of the driver}
+                MAX_CRITICALITY_LEVELS is set.
+
+    Purpose of the function: Sets the scheduling options to their defaults and reads the options given as arguments. Shared by the drivers of all the algorithms;
+                             the drivers which take no options (sweep, campaign) call it with argc = 0 to set the defaults. The options are:
+                                "demand": the allocation also accepts the cores which pass the exact demand-based EDF-VD test only (DPS).
+                                "converge <window> <tolerance>": the simulation is checked every <window> time units and stops when the metrics have converged within <tolerance>.
+                                "capacity <jobs>": the discarded queue holds at most <jobs> jobs, and the jobs beyond it are evicted.
+                                "percore": a criticality change raises the level of the core whose job overran its WCET counter only.
+                                "modereturn": the criticality level is lowered when a job completes, to the highest level of the jobs left in the ready queues.
+                                "migrate": a discarded job which does not fit in the slack of its own core is placed at once on another core with enough slack.
+                                "knapsack [values]": the discarded jobs to readmit are chosen by a knapsack. It may be followed by the value of a unit of execution time
+                                                     of each criticality level, from the lowest (e.g. "knapsack 1 2 4 8"); the values not given are 1.
+                                "check": the criticality levels of the cores are checked after each criticality change and return (for debugging).
+                             The options which do not apply to an algorithm have no effect on it.
+
+    Postconditions:
+        Output: {void}
+        Result: The option globals are set and readmission_value is allocated.
+*/
+void parse_options(int argc, char *argv[])
+{
+    int i, l;
+
+    simulation_horizon = 0.00;
+    demand_allocation = 0;
+    convergence_window = 0.00;
+    convergence_tolerance = 0.00;
+    discarded_capacity = 0;
+    per_core_mode = 0;
+    mode_return = 0;
+    discarded_migration = 0;
+    knapsack_readmission = 0;
+    mode_check = 0;
+    readmission_value = (double *)malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+    for (l = 0; l < MAX_CRITICALITY_LEVELS; l++)
+        readmission_value[l] = 1.00;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "demand") == 0)
+        {
+            demand_allocation = 1;
+        }
+        else if (strcmp(argv[i], "converge") == 0 && i + 2 < argc)
+        {
+            convergence_window = atof(argv[i + 1]);
+            convergence_tolerance = atof(argv[i + 2]);
+        }
+        else if (strcmp(argv[i], "capacity") == 0 && i + 1 < argc)
+        {
+            discarded_capacity = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "percore") == 0)
+        {
+            per_core_mode = 1;
+        }
+        else if (strcmp(argv[i], "modereturn") == 0)
+        {
+            mode_return = 1;
+        }
+        else if (strcmp(argv[i], "migrate") == 0)
+        {
+            discarded_migration = 1;
+        }
+        else if (strcmp(argv[i], "knapsack") == 0)
+        {
+            knapsack_readmission = 1;
+            for (l = 0; l < MAX_CRITICALITY_LEVELS && i + 1 + l < argc && ((argv[i + 1 + l][0] >= '0' && argv[i + 1 + l][0] <= '9') || argv[i + 1 + l][0] == '.'); l++)
+                readmission_value[l] = atof(argv[i + 1 + l]);
+        }
+        else if (strcmp(argv[i], "check") == 0)
+        {
+            mode_check = 1;
+        }
+    }
+    return;
+}
@@ -37,24 +37,18 @@ double find_superhyperperiod(task_set_struct *task_set)
 */
 double find_earliest_arrival_job(task_set_struct *task_set, int core_no, int curr_crit_level)
 {
+    task_table_struct *table = &(task_set->core_table[core_no]);
+    double min_arrival_time;
 
-    double min_arrival_time = INT_MAX;
-    int i;
-
-    for (i = 0; i < task_set->total_tasks; i++)
-    {
-        if (task_set->task_list[i].core == core_no)
-        {
-            min_arrival_time = min(min_arrival_time, task_set->task_list[i].phase + task_set->task_list[i].period * task_set->task_list[i].job_number);
-        }
-    }
+    //The next release of all the tasks of the core is computed by the vector kernel over the task table.
+    min_arrival_time = find_min_next_release(table, 0, table->num_tasks);
 
     return min_arrival_time;
 }
 
 /*
     Preconditions: 
-        Input: {pointer to taskset, pointer to ready queue, pointer to core}
+        Input: {pointer to taskset, pointer to processor, the core number}
 
     Purpose of the function: This function will find the next decision point of the core. 
                              The decision point will be the minimum of the earliest arrival job, the completion time of currently executing job, the WCET counter of currently executing job and the timer expiry of the core.
@@ -65,78 +59,156 @@ double find_earliest_arrival_job(task_set_struct *task_set, int core_no, int cur
         
   
 */
-decision_struct find_decision_point(task_set_struct *task_set, processor_struct *processor, double super_hyperperiod)
+decision_struct find_core_decision_point(task_set_struct *task_set, processor_struct *processor, int core_no)
 {
-
     double arrival_time, completion_time, expiry_time, WCET_counter;
-    double min_time;
     decision_struct decision;
-    double decision_time = INT_MAX;
-    int decision_core;
-    int decision_point;
-    int i, flag = 0;
 
-    decision.core_no = -1;
+    completion_time = INT_MAX;
+    expiry_time = INT_MAX;
+    WCET_counter = INT_MAX;
+    arrival_time = INT_MAX;
 
-    // fprintf(output[decision_core], "Finding decision point\n");
-    for (i = 0; i < processor->total_cores; i++)
+    if (processor->cores[core_no].state == ACTIVE)
+    {
+        arrival_time = find_earliest_arrival_job(task_set, core_no, processor->cores[core_no].crit_level);
+    }
+    else
     {
-        completion_time = INT_MAX;
-        expiry_time = INT_MAX;
-        WCET_counter = INT_MAX;
-        arrival_time = INT_MAX;
-        flag = 0;
+        expiry_time = processor->cores[core_no].next_invocation_time;
+    }
 
-        if (processor->cores[i].state == ACTIVE)
-        {
-            arrival_time = find_earliest_arrival_job(task_set, i, processor->crit_level);
-        }
-        else
+    if (processor->cores[core_no].curr_exec_job != NULL)
+    {
+        completion_time = processor->cores[core_no].curr_exec_job->completion_time;
+        if (processor->cores[core_no].crit_level < (MAX_CRITICALITY_LEVELS - 1))
         {
-            expiry_time = processor->cores[i].next_invocation_time;
+            WCET_counter = processor->cores[core_no].WCET_counter;
         }
+    }
+
+    decision.core_no = core_no;
+    decision.decision_time = min(min(min(arrival_time, completion_time), WCET_counter), expiry_time);
+
+    if (decision.decision_time == completion_time)
+    {
+        decision.decision_point = COMPLETION;
+    }
+    else if (decision.decision_time == expiry_time)
+    {
+        decision.decision_point = TIMER_EXPIRE;
+    }
+    else if (decision.decision_time == WCET_counter)
+    {
+        decision.decision_point = CRIT_CHANGE;
+    }
+    else
+    {
+        decision.decision_point = ARRIVAL;
+    }
+    // fprintf(output[core_no], "Core: %d, Arrival time: %.5lf, Completion time: %.5lf, Timer expiry: %.5lf, WCET counter: %.5lf\n", core_no, arrival_time, completion_time, expiry_time, WCET_counter);
+
+    return decision;
+}
 
-        if (processor->cores[i].curr_exec_job != NULL)
+/*
+    Preconditions: 
+        Input: {pointer to taskset, pointer to processor}
+
+    Purpose of the function: This function will find the next decision point of the processor, the earliest decision point of all the cores.
+                             If several cores have their decision point at the earliest time, the core with the lowest number is returned.
+
+    Postconditions: 
+        Output: {the decision point, decision time, core number}
+        Decision point = ARRIVAL or COMPLETION or TIMER_EXPIRE or CRIT_CHANGE
+*/
+decision_struct find_decision_point(task_set_struct *task_set, processor_struct *processor, double super_hyperperiod)
+{
+    decision_struct decision, core_decision;
+    int i;
+
+    decision.core_no = -1;
+    decision.decision_time = INT_MAX;
+
+    for (i = 0; i < processor->total_cores; i++)
+    {
+        core_decision = find_core_decision_point(task_set, processor, i);
+        if (decision.decision_time > core_decision.decision_time || decision.core_no == -1)
         {
-            flag = 1;
-            completion_time = processor->cores[i].curr_exec_job->completion_time;
-            if (processor->crit_level < (MAX_CRITICALITY_LEVELS - 1))
-            {
-                WCET_counter = processor->cores[i].WCET_counter;
-            }
+            decision = core_decision;
         }
+    }
 
-        min_time = min(min(min(arrival_time, completion_time), WCET_counter), expiry_time);
-        if (decision_time > min_time)
-        {
-            decision_time = min_time;
-            decision_core = i;
+    return decision;
+}
 
-            if (decision_time == completion_time)
-            {
-                decision_point = COMPLETION;
-            }
-            else if (decision_time == expiry_time)
-            {
-                decision_point = TIMER_EXPIRE;
-            }
-            else if (decision_time == WCET_counter)
-            {
-                decision_point = CRIT_CHANGE;
-            }
-            else if (decision_time == arrival_time)
-            {
-                decision_point = ARRIVAL;
-            }
-            // fprintf(output[i], "Core: %d, Curr job: %d,%d. Arrival time: %.5lf, Completion time: %.5lf, Timer expiry: %.5lf, WCET counter: %.5lf\n", i, (flag == 1 ? processor->cores[i].curr_exec_job->task_number : -1), (flag == 1 ? processor->cores[i].curr_exec_job->job_number : -1), arrival_time, completion_time, expiry_time, WCET_counter);
-        }
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to processor, array of NUM_CORES decision points}
+
+    Purpose of the function: With harmonic periods, the decision points of several cores often fall at the same time. The decision points of all the cores are
+                             found in one sweep, and every core with its decision point at the earliest time is returned, in increasing order of core (the order in
+                             which find_decision_point would return them one by one).
+                             Handling the decision point of a core other than a criticality change only changes the decision point of that core, so the others stay valid
+                             until the batch is handled. The scheduler checks the handled core again (find_core_decision_point) before moving to the next core of the batch.
+
+    Postconditions:
+        Output: {The number of decision points stored in decisions}
+*/
+int find_decision_points(task_set_struct *task_set, processor_struct *processor, decision_struct decisions[])
+{
+    decision_struct core_decision[NUM_CORES];
+    double decision_time = INT_MAX;
+    int i, num_decisions = 0;
+
+    for (i = 0; i < processor->total_cores; i++)
+    {
+        core_decision[i] = find_core_decision_point(task_set, processor, i);
+        decision_time = min(decision_time, core_decision[i].decision_time);
+    }
+
+    for (i = 0; i < processor->total_cores; i++)
+    {
+        if (core_decision[i].decision_time == decision_time)
+            decisions[num_decisions++] = core_decision[i];
     }
 
-    decision.core_no = decision_core;
-    decision.decision_point = decision_point;
-    decision.decision_time = decision_time;
+    return num_decisions;
+}
 
-    return decision;
+/*
+    Preconditions:
+        Input: {pointer to processor, the time of the next decision points}
+                No core has a job to execute (check_all_cores) and curr_time is before the end of the simulation.
+
+    Purpose of the function: Fast-forwards an idle processor: every core is brought to the time of the next decision points at once, its time since its last
+                             decision point being accounted as shutdown time if it is shut down, else as idle time. The decision points handled at that time
+                             then have nothing left to account, and the cores without a decision point at that time are not left behind until their own.
+
+    Postconditions:
+        Output: {void}
+        Result: The total_time of every core is curr_time.
+*/
+void fast_forward_idle_cores(processor_struct *processor, double curr_time)
+{
+    int num_core;
+    double idle_time;
+
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        idle_time = curr_time - processor->cores[num_core].total_time;
+        if (idle_time <= 0.00)
+            continue;
+
+        processor->cores[num_core].total_idle_time += idle_time;
+        if (processor->cores[num_core].state == SHUTDOWN)
+            stats->total_shutdown_time[num_core] += idle_time;
+        else
+            stats->total_idle_energy[num_core] += idle_time;
+        processor->cores[num_core].total_time = curr_time;
+    }
+
+    return;
 }
 
 /*
@@ -154,89 +226,246 @@ double find_max_slack(task_set_struct *task_set, int crit_level, int core_no, do
 {
     int i, task_number, task_crit_level;
     double max_slack = deadline - curr_time;
+    task_table_struct *table = &(task_set->core_table[core_no]);
 
     fprintf(output[core_no], "Function to find maximum slack\n");
     fprintf(output[core_no], "Max slack: %.5lf, Deadline: %.5lf, Curr time: %.5lf\n", max_slack, deadline, curr_time);
 
-    job *temp = ready_queue->job_list_head;
+    job *temp, *cursor[MAX_CRITICALITY_LEVELS];
 
     fprintf(output[core_no], "Traversing ready queue\n");
 
-    //First traverse the ready queue and update the maximum slack according to remaining execution time of jobs.
-    while (temp)
+    //First traverse the ready queue (in the order of the deadlines) and update the maximum slack according to remaining execution time of jobs.
+    memcpy(cursor, ready_queue->level_head, sizeof(job *) * MAX_CRITICALITY_LEVELS);
+    while ((temp = next_job_in_order(cursor)) != NULL)
     {
         task_number = temp->task_number;
         task_crit_level = task_set->task_list[task_number].criticality_lvl;
         double rem_exec_time = task_set->task_list[task_number].WCET[task_crit_level] - (temp->execution_time - temp->rem_exec_time);
+        double job_deadline = find_job_deadline(temp);
 
-        if(temp->absolute_deadline > deadline) {
-            max_slack -= (deadline - curr_time) / (temp->absolute_deadline - curr_time) * rem_exec_time;
+        if(job_deadline > deadline) {
+            max_slack -= (deadline - curr_time) / (job_deadline - curr_time) * rem_exec_time;
         }
         else {
             max_slack -= rem_exec_time;
         }
-        fprintf(output[core_no], "Job: %d, rem execution time: %.5lf, deadline: %.5lf, max slack: %.5lf\n", temp->task_number, rem_exec_time, temp->absolute_deadline, max_slack);
-        temp = temp->next;
+        fprintf(output[core_no], "Job: %d, rem execution time: %.5lf, deadline: %.5lf, max slack: %.5lf\n", temp->task_number, rem_exec_time, job_deadline, max_slack);
     }
 
     fprintf(output[core_no], "Traversing task list\n");
     //Then, traverse the task list and update the maximum slack according to future invocations of the tasks.
-    for (i = 0; i < task_set->total_tasks; i++)
+    for (i = table->level_start[crit_level]; i < table->num_tasks; i++)
     {
-        if (task_set->task_list[i].core == core_no && task_set->task_list[i].criticality_lvl >= crit_level)
+        int curr_jobs = table->job_number[i];
+        double exec_time = table->WCET[i];
+        double release_time;
+        while ((release_time = (table->phase[i] + table->period[i] * curr_jobs)) < deadline)
         {
-            int curr_jobs = task_set->task_list[i].job_number;
-            task_crit_level = task_set->task_list[i].criticality_lvl;
-            double exec_time = task_set->task_list[i].WCET[task_crit_level];
-            double release_time;
-            while ((release_time = (task_set->task_list[i].phase + task_set->task_list[i].period * curr_jobs)) < deadline)
-            {
-                double task_deadline = (release_time + task_set->task_list[i].virtual_deadline);
-                if(task_deadline > deadline) {
-                    max_slack -= (deadline - release_time) / task_set->task_list[i].period * exec_time;
-                }
-                else {
-                    max_slack -= exec_time;
-                }
-                fprintf(output[core_no], "Task: %d, exec time: %.5lf, deadline: %.5lf, max slack: %.5lf\n", i, exec_time, task_deadline, max_slack);
-                curr_jobs++;
+            double task_deadline = (release_time + table->virtual_deadline[i]);
+            if(task_deadline > deadline) {
+                max_slack -= (deadline - release_time) / table->period[i] * exec_time;
+            }
+            else {
+                max_slack -= exec_time;
             }
+            fprintf(output[core_no], "Task: %d, exec time: %.5lf, deadline: %.5lf, max slack: %.5lf\n", table->task_number[i], exec_time, task_deadline, max_slack);
+            curr_jobs++;
         }
     }
 
     return max(max_slack, 0.00);
 }
 
+/*
+    Function to compare two knapsack items for qsort: the earlier deadline first, then the earlier position in the discarded queue.
+*/
+static int compare_knapsack_items(const void *a, const void *b)
+{
+    const knapsack_item_struct *A = (const knapsack_item_struct *)a, *B = (const knapsack_item_struct *)b;
+
+    if (A->deadline != B->deadline)
+        return (A->deadline < B->deadline) ? -1 : 1;
+    return A->position - B->position;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the ready queue, pointer to the discarded queue, pointer to taskset, the core number, the current criticality level, the current time}
+                (*discarded_queue)->num_jobs > 0
+
+    Purpose of the function: Chooses the discarded jobs to readmit to the ready queue of the core as a knapsack, instead of admitting them greedily one by one.
+                             The candidates are the discarded jobs whose remaining WCET fits in the maximum slack of the core before their deadlines (find_max_slack,
+                             with the current ready queue). Taken in the order of the deadlines, a set of jobs fits if, at the deadline of each job, the total remaining
+                             WCET of the jobs up to that deadline is within the slack (as in the dynamic program of Lawler and Moore for the on-time jobs).
+                             The dynamic program is over the total remaining WCET, counted in units of 1/KNAPSACK_BINS of the total of the candidates. The WCETs are
+                             rounded up and the slacks down, so the chosen set always fits, and the value of the set is within one unit per job of the best one.
+                             The value of a job is readmission_value of its criticality level times its remaining WCET.
+
+    Postconditions:
+        Output: {void}
+        Result: The chosen jobs are moved from the discarded queue to the ready queue.
+*/
+void select_discarded_jobs(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int core_no, int curr_crit_level, double curr_time)
+{
+    int num_jobs = (*discarded_queue)->num_jobs, num_items = 0, total_weight = 0, level, position, i, weight, best_weight;
+    knapsack_item_struct *items = (knapsack_item_struct *)malloc(sizeof(knapsack_item_struct) * num_jobs);
+    char *chosen = (char *)calloc(num_jobs, sizeof(char)), *take;
+    double rem_exec_time, max_slack, total_work = 0.00, unit, *best;
+    task *curr_task;
+    job *curr, **link;
+
+    //Find the candidates and their slacks.
+    position = 0;
+    for (level = MAX_CRITICALITY_LEVELS - 1; level >= 0; level--)
+    {
+        for (curr = (*discarded_queue)->level_head[level]; curr != NULL; curr = curr->next, position++)
+        {
+            curr_task = curr->job_task;
+            //The jobs of the other cores are only candidates if their deadlines are fixed, as in accommodate_discarded_jobs.
+            if (curr_task->core != core_no && curr_task->virtual_deadline != curr_task->relative_deadline)
+                continue;
+            rem_exec_time = curr_task->WCET[curr_task->criticality_lvl] - (curr->execution_time - curr->rem_exec_time);
+            max_slack = find_max_slack(task_set, curr_crit_level, core_no, find_job_deadline(curr), curr_time, (*ready_queue));
+            fprintf(output[core_no], "Discarded job: %d,%d, Exec time: %5lf, Max slack: %.5lf\n", curr->task_number, curr->job_number, rem_exec_time, max_slack);
+
+            if (max_slack >= rem_exec_time)
+            {
+                items[num_items].discarded_job = curr;
+                items[num_items].position = position;
+                items[num_items].deadline = find_job_deadline(curr);
+                items[num_items].exec_time = rem_exec_time;
+                items[num_items].slack = max_slack;
+                items[num_items].value = readmission_value[curr_task->criticality_lvl] * rem_exec_time;
+                total_work += rem_exec_time;
+                num_items++;
+            }
+        }
+    }
+
+    if (num_items == 0)
+    {
+        free(items);
+        free(chosen);
+        return;
+    }
+
+    unit = (total_work > 0.00) ? total_work / KNAPSACK_BINS : 1.00;
+    for (i = 0; i < num_items; i++)
+    {
+        items[i].weight = max_int(0, (int)ceil(items[i].exec_time / unit - 1e-9));
+        total_weight += items[i].weight;
+    }
+    for (i = 0; i < num_items; i++)
+        items[i].capacity = (int)min(total_weight, floor(items[i].slack / unit + 1e-9));
+    qsort(items, num_items, sizeof(knapsack_item_struct), compare_knapsack_items);
+
+    //best[w] is the best value of a set of the jobs seen so far with total weight w (negative if there is none), take[i][w] is set if job i is in that set.
+    best = (double *)malloc(sizeof(double) * (total_weight + 1));
+    take = (char *)calloc((size_t)num_items * (total_weight + 1), sizeof(char));
+    best[0] = 0.00;
+    for (weight = 1; weight <= total_weight; weight++)
+        best[weight] = -1.00;
+
+    for (i = 0; i < num_items; i++)
+    {
+        for (weight = items[i].capacity - items[i].weight; weight >= 0; weight--)
+        {
+            if (best[weight] >= 0.00 && best[weight] + items[i].value > best[weight + items[i].weight])
+            {
+                best[weight + items[i].weight] = best[weight] + items[i].value;
+                take[(size_t)i * (total_weight + 1) + weight + items[i].weight] = 1;
+            }
+        }
+    }
+
+    best_weight = 0;
+    for (weight = 1; weight <= total_weight; weight++)
+    {
+        if (best[weight] > best[best_weight])
+            best_weight = weight;
+    }
+
+    weight = best_weight;
+    for (i = num_items - 1; i >= 0; i--)
+    {
+        if (take[(size_t)i * (total_weight + 1) + weight])
+        {
+            chosen[items[i].position] = 1;
+            weight -= items[i].weight;
+        }
+    }
+
+    //Move the chosen jobs to the ready queue, in the order of the discarded queue.
+    position = 0;
+    for (level = MAX_CRITICALITY_LEVELS - 1; level >= 0; level--)
+    {
+        link = &((*discarded_queue)->level_head[level]);
+        while (*link != NULL)
+        {
+            curr = *link;
+            if (chosen[position++])
+            {
+                *link = curr->next;
+                curr->next = NULL;
+                (*discarded_queue)->num_jobs--;
+                fprintf(output[core_no], "Job %d,%d inserted in ready queue of core %d\n", curr->task_number, curr->job_number, core_no);
+                insert_job_in_ready_queue(ready_queue, curr);
+                stats->total_discarded_jobs[core_no]++;
+            }
+            else
+                link = &(curr->next);
+        }
+    }
+
+    free(items);
+    free(chosen);
+    free(best);
+    free(take);
+
+    return;
+}
+
 void accommodate_discarded_jobs(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int core_no, int curr_crit_level, double curr_time)
 {
     job *ready_job, *prev, *curr, *dummy_node;
 
-    dummy_node = (job*)malloc(sizeof(job));
-    dummy_node->next = (*discarded_queue)->job_list_head;
-
     double max_slack, rem_exec_time;
     int crit_level;
 
     fprintf(output[core_no], "Discarded job list\n");
-    print_job_list(core_no, (*discarded_queue)->job_list_head);
+    print_job_queue(core_no, (*discarded_queue));
 
     if ((*discarded_queue)->num_jobs == 0)
         return;
 
     fprintf(output[core_no], "Accommodating discarded jobs in ready queue of core %d\n", core_no);
 
+    if (knapsack_readmission)
+    {
+        select_discarded_jobs(ready_queue, discarded_queue, task_set, core_no, curr_crit_level, curr_time);
+        return;
+    }
+
+    dummy_node = (job*)malloc(sizeof(job));
+
+    //The discarded jobs are tried from the highest criticality level to the lowest, first the jobs of this core and then the jobs of the other cores.
+    //A job of another core is only taken if its deadline is fixed (the virtual deadline of its task is the relative deadline): the virtual deadlines
+    //of a core change when its criticality level passes its threshold level, and only the queues of that core are sorted again.
     for(int i=MAX_CRITICALITY_LEVELS - 1; i >= 0; i--) {
+        dummy_node->next = (*discarded_queue)->level_head[i];
+
         prev = dummy_node;
-        curr = (*discarded_queue)->job_list_head;
+        curr = dummy_node->next;
         while(curr != NULL)
         {
-            if(task_set->task_list[curr->task_number].criticality_lvl == i && task_set->task_list[curr->task_number].core == core_no)
+            if(task_set->task_list[curr->task_number].core == core_no)
             {
                 crit_level = task_set->task_list[curr->task_number].criticality_lvl;            
                 rem_exec_time = task_set->task_list[curr->task_number].WCET[crit_level] - (curr->execution_time - curr->rem_exec_time);
                 fprintf(output[core_no], "Discarded job: %d,%d, Exec time: %5lf\n", curr->task_number, curr->job_number, rem_exec_time);
                 
-                max_slack = find_max_slack(task_set, curr_crit_level, core_no, curr->absolute_deadline, curr_time, (*ready_queue));
+                max_slack = find_max_slack(task_set, curr_crit_level, core_no, find_job_deadline(curr), curr_time, (*ready_queue));
                 fprintf(output[core_no], "Max slack: %.5lf | ", max_slack);
 
                 if(max_slack >= rem_exec_time)
@@ -264,16 +493,16 @@ void accommodate_discarded_jobs(job_queue_struct **ready_queue, job_queue_struct
         }
 
         prev = dummy_node;
-        curr = (*discarded_queue)->job_list_head;
+        curr = dummy_node->next;
         while(curr != NULL)
         {
-            if(task_set->task_list[curr->task_number].criticality_lvl == i && task_set->task_list[curr->task_number].core != core_no)
+            if(task_set->task_list[curr->task_number].core != core_no && curr->job_task->virtual_deadline == curr->job_task->relative_deadline)
             {
                 crit_level = task_set->task_list[curr->task_number].criticality_lvl;            
                 rem_exec_time = task_set->task_list[curr->task_number].WCET[crit_level] - (curr->execution_time - curr->rem_exec_time);
                 fprintf(output[core_no], "Discarded job: %d,%d, Exec time: %5lf\n", curr->task_number, curr->job_number, rem_exec_time);
                 
-                max_slack = find_max_slack(task_set, curr_crit_level, core_no, curr->absolute_deadline, curr_time, (*ready_queue));
+                max_slack = find_max_slack(task_set, curr_crit_level, core_no, find_job_deadline(curr), curr_time, (*ready_queue));
                 fprintf(output[core_no], "Max slack: %.5lf | ", max_slack);
 
                 if(max_slack > rem_exec_time)
@@ -300,15 +529,158 @@ void accommodate_discarded_jobs(job_queue_struct **ready_queue, job_queue_struct
             }
         }
 
+        (*discarded_queue)->level_head[i] = dummy_node->next;
     }
 
-    (*discarded_queue)->job_list_head = dummy_node->next;
     dummy_node->next = NULL;
     free(dummy_node);
 
     return;
 }
 
+/*
+    Function to create the slack index of the cores of the processor. The entries are filled by update_slack_index.
+*/
+slack_index_struct *initialize_slack_index(processor_struct *processor)
+{
+    slack_index_struct *slack_index = (slack_index_struct *)malloc(sizeof(slack_index_struct));
+
+    slack_index->committed_work = (double *)calloc(processor->total_cores, sizeof(double));
+    slack_index->index_time = (double *)calloc(processor->total_cores, sizeof(double));
+    slack_index->utilisation = (double *)calloc(processor->total_cores, sizeof(double));
+
+    return slack_index;
+}
+
+/*
+    Function to free the slack index.
+*/
+void free_slack_index(slack_index_struct *slack_index)
+{
+    free(slack_index->committed_work);
+    free(slack_index->index_time);
+    free(slack_index->utilisation);
+    free(slack_index);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to processor, pointer to taskset, the core number}
+                processor->slack_index!=NULL
+
+    Purpose of the function: Updates the entry of the core in the slack index at the current time of the core: the remaining WCET of the jobs in its ready queue
+                             (counted as in find_max_slack) and the utilisation of its tasks at the criticality level of the core. It is called at each decision point of the core.
+
+    Postconditions:
+        Output: {void}
+*/
+void update_slack_index(processor_struct *processor, task_set_struct *task_set, int core_no)
+{
+    slack_index_struct *slack_index = processor->slack_index;
+    task_table_struct *table = &(task_set->core_table[core_no]);
+    job *curr;
+    int i, level, crit_level = processor->cores[core_no].crit_level;
+    double committed_work = 0.00, utilisation = 0.00;
+
+    for (level = 0; level < MAX_CRITICALITY_LEVELS; level++)
+    {
+        for (curr = processor->cores[core_no].ready_queue->level_head[level]; curr != NULL; curr = curr->next)
+        {
+            committed_work += curr->job_task->WCET[curr->job_task->criticality_lvl] - (curr->execution_time - curr->rem_exec_time);
+        }
+    }
+
+    for (i = table->level_start[crit_level]; i < table->num_tasks; i++)
+    {
+        utilisation += table->util[i * MAX_CRITICALITY_LEVELS + crit_level];
+    }
+
+    slack_index->committed_work[core_no] = committed_work;
+    slack_index->index_time[core_no] = processor->cores[core_no].total_time;
+    slack_index->utilisation[core_no] = utilisation;
+
+    return;
+}
+
+/*
+    Function to estimate the slack of the core between the current time and the deadline from its entry in the slack index.
+    The committed work is executed from the time of the entry, and the tasks of the core take their utilisation of the rest of the interval.
+*/
+double estimate_core_slack(slack_index_struct *slack_index, int core_no, double deadline, double curr_time)
+{
+    double committed_work = max(0.00, slack_index->committed_work[core_no] - (curr_time - slack_index->index_time[core_no]));
+
+    return (1.00 - slack_index->utilisation[core_no]) * (deadline - curr_time) - committed_work;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to processor, pointer to taskset, the discarded job, the core of the job, the current time}
+                processor->slack_index!=NULL
+                discarded_job!=NULL
+
+    Purpose of the function: Finds a core for a job discarded on its own core, instead of leaving it in the discarded queue until a core becomes idle.
+                             The candidates are the other cores which are active and idle, so the job is executed in time which would otherwise be spent idle: a shutdown core
+                             is not woken up, and the slack of a busy core is left to its own discarded jobs. The chosen core starts the job at once. The candidates are tried in the decreasing order of the slack estimated from the slack index, skipping the cores whose estimate is less than the remaining
+                             WCET of the job. The first core whose maximum slack (find_max_slack) is greater than the remaining WCET of the job gets the job in its ready queue.
+
+    Postconditions:
+        Output: {1 if the job was inserted in the ready queue of another core, else 0}
+        Result: The chosen core is brought to the current time and executes the job. Its slack index entry is updated.
+*/
+int migrate_discarded_job(processor_struct *processor, task_set_struct *task_set, job *discarded_job, int core_no, double curr_time)
+{
+    int candidates[NUM_CORES], num_candidates = 0, num_core, i, j;
+    double estimate[NUM_CORES], max_slack, deadline = find_job_deadline(discarded_job);
+    double rem_exec_time = discarded_job->job_task->WCET[discarded_job->job_task->criticality_lvl] - (discarded_job->execution_time - discarded_job->rem_exec_time);
+
+    //The deadline of the job must not move while it is on another core, as in accommodate_discarded_jobs.
+    if (discarded_job->job_task->virtual_deadline != discarded_job->job_task->relative_deadline)
+        return 0;
+
+    //Order the candidate cores by the estimated slack (insertion sort, the number of cores is small).
+    for (num_core = 0; num_core < processor->total_cores; num_core++)
+    {
+        if (num_core == core_no || processor->cores[num_core].state != ACTIVE || processor->cores[num_core].curr_exec_job != NULL)
+            continue;
+
+        estimate[num_core] = estimate_core_slack(processor->slack_index, num_core, deadline, curr_time);
+        if (estimate[num_core] < rem_exec_time)
+            continue;
+
+        for (i = num_candidates; i > 0 && estimate[candidates[i - 1]] < estimate[num_core]; i--)
+            candidates[i] = candidates[i - 1];
+        candidates[i] = num_core;
+        num_candidates++;
+    }
+
+    for (j = 0; j < num_candidates; j++)
+    {
+        num_core = candidates[j];
+        max_slack = find_max_slack(task_set, processor->cores[num_core].crit_level, num_core, deadline, curr_time, processor->cores[num_core].ready_queue);
+        fprintf(output[num_core], "Discarded job %d,%d of core %d | Estimated slack: %.5lf, Max slack: %.5lf | ", discarded_job->task_number, discarded_job->job_number, core_no, estimate[num_core], max_slack);
+
+        if (max_slack > rem_exec_time)
+        {
+            fprintf(output[num_core], "Job %d,%d inserted in ready queue of core %d\n", discarded_job->task_number, discarded_job->job_number, num_core);
+            insert_job_in_ready_queue(&(processor->cores[num_core].ready_queue), discarded_job);
+            stats->total_discarded_jobs[num_core]++;
+
+            //The core was idle up to now, and executes the job from now on.
+            stats->total_idle_energy[num_core] += (curr_time - processor->cores[num_core].total_time);
+            processor->cores[num_core].total_idle_time += (curr_time - processor->cores[num_core].total_time);
+            processor->cores[num_core].total_time = curr_time;
+            stats->total_context_switches[num_core]++;
+            schedule_new_job(&(processor->cores[num_core]), processor->cores[num_core].ready_queue, task_set);
+            update_slack_index(processor, task_set, num_core);
+            return 1;
+        }
+        fprintf(output[num_core], "Not enough slack\n");
+    }
+
+    return 0;
+}
+
 /*
     Preconditions: 
         Input: {pointer to taskset, pointer to the newly arrived job, the task number of job, the release time of the job, pointer to the core}
@@ -329,14 +701,17 @@ void find_job_parameters(task *task_list, job *new_job, int task_number, int job
 
     new_job->release_time = release_time;
 
-    actual_exec_time = task_list[task_number].exec_times[job_number];
+    actual_exec_time = find_job_execution_time(&task_list[task_number], job_number);
 
     new_job->execution_time = actual_exec_time;
     new_job->rem_exec_time = new_job->execution_time;
     new_job->WCET_counter = task_list[task_number].WCET[curr_crit_level];
+    new_job->budget_level = curr_crit_level;
     new_job->task_number = task_number;
-    new_job->absolute_deadline = new_job->release_time + task_list[task_number].virtual_deadline;
+    new_job->job_task = &task_list[task_number];
     new_job->job_number = job_number;
+    new_job->criticality_lvl = task_list[task_number].criticality_lvl;
+    new_job->discarded = 0;
     new_job->next = NULL;
 
     return;
@@ -344,22 +719,48 @@ void find_job_parameters(task *task_list, job *new_job, int task_number, int job
 
 /*
     Preconditions:
-        Input: {pointer to job queue, pointer to taskset, pointer to core}
+        Input: {pointer to the task, the current time}
+                curr_task!=NULL
+
+    Purpose of the function: Finds the number of jobs of the task, starting from its next job (job_number), whose deadlines are before the current time.
+                             The first job whose deadline is not before the current time is found from the period and then corrected by one job on either side,
+                             so the deadlines are compared exactly as they are computed for the arriving jobs.
+
+    Postconditions:
+        Output: {The number of missed jobs}
+*/
+int find_missed_jobs(task *curr_task, double curr_time)
+{
+    int next_job = curr_task->job_number;
+
+    next_job = max_int(next_job, (int)ceil((curr_time - curr_task->phase - curr_task->virtual_deadline) / curr_task->period));
+    while (next_job > curr_task->job_number && (curr_task->phase + curr_task->period * (next_job - 1)) + curr_task->virtual_deadline >= curr_time)
+        next_job--;
+    while ((curr_task->phase + curr_task->period * next_job) + curr_task->virtual_deadline < curr_time)
+        next_job++;
+
+    return next_job - curr_task->job_number;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to job queue, pointer to taskset, pointer to processor}
                 ready_queue!=NULL
                 task_set!=NULL
-                core!=NULL
+                processor!=NULL
 
     Purpose of the function: This function will insert all the jobs which have arrived at the current time unit in the ready queue. The ready queue is sorted according to the deadlines.
                              It will also compute the procrastination length which is the minimum of the procrastination intervals of all newly arrived jobs.
+                             A discarded job which does not fit in the slack of the core is migrated to another core if discarded_migration is set (migrate_discarded_job).
     Postconditions: 
         Output: {Returns the procrastination length to update the core timer}
         Result: An updated ready queue with all the newly arrived jobs inserted in their right positions.
 */
-void update_job_arrivals(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int curr_crit_level, double curr_time, int core_no, core_struct *core, int algo, int timer_expiry)
+void update_job_arrivals(job_queue_struct **ready_queue, job_queue_struct **discarded_queue, task_set_struct *task_set, int curr_crit_level, double curr_time, int core_no, processor_struct *processor, int algo, int timer_expiry)
 {
-    int total_tasks = task_set->total_tasks;
     task *task_list = task_set->task_list;
-    int curr_task, crit_level;
+    task_index_struct *index = &(task_set->core_index[core_no]);
+    int num_task, curr_task, crit_level;
     job *new_job;
 
     fprintf(output[core_no], "INSERTING JOBS IN READY/DISCARDED QUEUE\n");
@@ -367,62 +768,73 @@ void update_job_arrivals(job_queue_struct **ready_queue, job_queue_struct **disc
     //Update the job arrivals from highest criticality level to the lowest.
     for (crit_level = MAX_CRITICALITY_LEVELS - 1; crit_level >= 0; crit_level--)
     {
-        for (curr_task = 0; curr_task < total_tasks; curr_task++)
+        for (num_task = 0; num_task < index->num_tasks[crit_level]; num_task++)
         {
-            if (task_list[curr_task].criticality_lvl == crit_level && task_list[curr_task].core == core_no)
+            curr_task = index->task_list[crit_level][num_task];
+            double max_exec_time = task_list[curr_task].WCET[curr_crit_level];
+            double release_time = (task_list[curr_task].phase + task_list[curr_task].period * task_list[curr_task].job_number);
+            double deadline = release_time + task_list[curr_task].virtual_deadline;
+
+            //The jobs whose deadlines passed while the core was shut down (or the task was discarded) are skipped at once.
+            if (deadline < curr_time)
             {
-                double max_exec_time = task_list[curr_task].WCET[curr_crit_level];
-                double release_time = (task_list[curr_task].phase + task_list[curr_task].period * task_list[curr_task].job_number);
-                double deadline = release_time + task_list[curr_task].virtual_deadline;
+                int num_missed = find_missed_jobs(&task_list[curr_task], curr_time);
+                if(task_list[curr_task].criticality_lvl < curr_crit_level)
+                {   
+                    stats->total_discarded_jobs_available[core_no] += find_jobs_execution_time(&task_list[curr_task], task_list[curr_task].job_number, num_missed);
+                }
 
-                while (deadline < curr_time)
-                {
-                    if(task_list[curr_task].criticality_lvl < curr_crit_level)
-                    {   
-                        stats->total_discarded_jobs_available[core_no] += task_list[curr_task].exec_times[task_list[curr_task].job_number];
-                    }
+                task_list[curr_task].job_number += num_missed;
+                release_time = (task_list[curr_task].phase + task_list[curr_task].period * task_list[curr_task].job_number);
+                deadline = release_time + task_list[curr_task].virtual_deadline;
+            }
 
-                    task_list[curr_task].job_number++;
-                    release_time = (task_list[curr_task].phase + task_list[curr_task].period * task_list[curr_task].job_number);
-                    deadline = release_time + task_list[curr_task].virtual_deadline;
-                }
+            if (release_time <= curr_time)
+            {
+                new_job = (job *)malloc(sizeof(job));
+                find_job_parameters(task_list, new_job, curr_task, task_list[curr_task].job_number, release_time, curr_crit_level);
 
-                if (release_time <= curr_time)
+                fprintf(output[core_no], "Job %d,%d arrived | ", curr_task, task_list[curr_task].job_number);
+                if (crit_level >= curr_crit_level)
                 {
-                    new_job = (job *)malloc(sizeof(job));
-                    find_job_parameters(task_list, new_job, curr_task, task_list[curr_task].job_number, release_time, curr_crit_level);
+                    fprintf(output[core_no], "Normal job| Exec time: %.5lf | %s\n", new_job->execution_time, (new_job->execution_time > task_set->task_list[curr_task].WCET[curr_crit_level]) ? "More" : "Less");
+                    insert_job_in_ready_queue(ready_queue, new_job);
+                }
+                else if (algo != EDF_VD && timer_expiry != 1)
+                {
+                    fprintf(output[core_no], "Discarded job | ");
+                    new_job->discarded = 1;
+                    double max_slack = 0.00;
+                    max_slack = find_max_slack(task_set, curr_crit_level, core_no, deadline, curr_time, (*ready_queue));
+                    fprintf(output[core_no], "Max slack: %.5lf, Max exec: %.5lf | ", max_slack, max_exec_time);
+
+                    stats->total_discarded_jobs_available[core_no] += new_job->rem_exec_time;
 
-                    fprintf(output[core_no], "Job %d,%d arrived | ", curr_task, task_list[curr_task].job_number);
-                    if (crit_level >= curr_crit_level)
+                    if (max_slack >= max_exec_time)
                     {
-                        fprintf(output[core_no], "Normal job| Exec time: %.5lf | %s\n", new_job->execution_time, (new_job->execution_time > task_set->task_list[curr_task].WCET[curr_crit_level]) ? "More" : "Less");
+                        fprintf(output[core_no], "Inserting in ready queue\n");
+                        stats->total_discarded_jobs[core_no]++;
                         insert_job_in_ready_queue(ready_queue, new_job);
                     }
-                    else if (algo != EDF_VD && timer_expiry != 1)
+                    else if (processor->slack_index != NULL && migrate_discarded_job(processor, task_set, new_job, core_no, curr_time))
+                    {
+                        fprintf(output[core_no], "Migrated to another core\n");
+                    }
+                    else
                     {
-                        fprintf(output[core_no], "Discarded job | ");
-                        double max_slack = 0.00;
-                        max_slack = find_max_slack(task_set, curr_crit_level, core_no, deadline, curr_time, (*ready_queue));
-                        fprintf(output[core_no], "Max slack: %.5lf, Max exec: %.5lf | ", max_slack, max_exec_time);
-
-                        stats->total_discarded_jobs_available[core_no] += new_job->rem_exec_time;
-
-                        if (max_slack >= max_exec_time)
-                        {
-                            fprintf(output[core_no], "Inserting in ready queue\n");
-                            stats->total_discarded_jobs[core_no]++;
-                            insert_job_in_ready_queue(ready_queue, new_job);
-                        }
-                        else
-                        {
-                            fprintf(output[core_no], "Inserting in discarded queue\n");
-                            // stats->total_discarded_jobs_available[core_no] += new_job->rem_exec_time;
-                            insert_job_in_discarded_queue(discarded_queue, new_job, task_set->task_list, core_no);
-                        }
+                        fprintf(output[core_no], "Inserting in discarded queue\n");
+                        // stats->total_discarded_jobs_available[core_no] += new_job->rem_exec_time;
+                        insert_job_in_discarded_queue(discarded_queue, new_job, task_set->task_list, core_no);
                     }
-                    task_list[curr_task].job_number++;
                 }
+                else
+                {
+                    //The job is dropped (EDF_VD, or the core is woken up by its timer).
+                    free(new_job);
+                }
+                task_list[curr_task].job_number++;
             }
+            update_task_table(task_set, curr_task);
         }
     }
 
@@ -441,10 +853,11 @@ void update_job_arrivals(job_queue_struct **ready_queue, job_queue_struct **disc
 */
 void update_job_removal(task_set_struct *taskset, job_queue_struct **ready_queue)
 {
-    //Remove the currently executing job from the ready queue.
-    job *completed_job = (*ready_queue)->job_list_head;
-    (*ready_queue)->job_list_head = (*ready_queue)->job_list_head->next;
+    //Remove the currently executing job from the ready queue. It is the head of the ready queue, so it is the head of the list of its level.
+    job *completed_job = find_earliest_job(*ready_queue);
+    (*ready_queue)->level_head[completed_job->criticality_lvl] = completed_job->next;
     (*ready_queue)->num_jobs--;
+    count_ready_job(*ready_queue, completed_job, -1);
 
     free(completed_job);
 
@@ -457,7 +870,7 @@ void update_job_removal(task_set_struct *taskset, job_queue_struct **ready_queue
 
     Purpose of the function: This function will schedule a new job in the core. 
                              The time of scheduling of job and the time at which job will be completed is updated.
-                             The WCET counter of job is updated to indicate the time at which the job will cross its WCET.
+                             The budget of the job is brought up to the level of the ready queue, and the WCET counter of the core is updated to indicate the time at which the job will cross its WCET.
 
     Postconditions:
         Output: {void}
@@ -465,7 +878,8 @@ void update_job_removal(task_set_struct *taskset, job_queue_struct **ready_queue
 */
 void schedule_new_job(core_struct *core, job_queue_struct *ready_queue, task_set_struct *task_set)
 {
-    (*core).curr_exec_job = ready_queue->job_list_head;
+    (*core).curr_exec_job = find_earliest_job(ready_queue);
+    update_job_budget((*core).curr_exec_job, ready_queue->mode_level);
     (*core).curr_exec_job->scheduled_time = (*core).total_time;
     (*core).curr_exec_job->completion_time = (*core).total_time + (*core).curr_exec_job->rem_exec_time;
     (*core).WCET_counter = (*core).curr_exec_job->scheduled_time + (*core).curr_exec_job->WCET_counter;
@@ -0,0 +1,89 @@
+#include "functions.h"
+
+//The algorithms scheduled by run_all_algorithms, in the order of their results.
+static const int simulation_algorithms[NUM_ALGORITHMS] = {DPS, EDF_VD, EDF_VD_DJ, EDF};
+static const char *simulation_algorithm_names[NUM_ALGORITHMS] = {"DPS", "EDF-VD", "EDF-VD-DJ", "EDF"};
+
+/*
+    Function to get the name of the algorithm at index num_algo of the results of run_all_algorithms.
+*/
+const char *find_algorithm_name(int num_algo)
+{
+    return simulation_algorithm_names[num_algo];
+}
+
+/*
+    Preconditions:
+        Input: {total active time, total idle time}
+
+    Purpose of the function: Computes the energy as in export_csv.c: the active time is weighted by 1.00 and the idle time by 0.5, the total time by 0.5
+                             (static energy), and the sum is normalized by the active time.
+
+    Postconditions:
+        Output: {energy, 0 if there is no active time}
+*/
+double find_energy(double active_time, double idle_time)
+{
+    if (active_time <= 0.00)
+        return 0.00;
+
+    return ((active_time * 1.00 + idle_time * 0.5) + (active_time + idle_time) * 0.5) / active_time;
+}
+
+/*
+    Function to discard the logs of a thread running in-process simulations. Returns the file to close when the thread ends.
+*/
+FILE *discard_thread_output()
+{
+    FILE *null_file = fopen("/dev/null", "w");
+    int num_core;
+
+    output_file = null_file;
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        output[num_core] = null_file;
+    }
+    return null_file;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to taskset, pointer to the allocation, array of NUM_ALGORITHMS results}
+                allocation->feasible == 1 and the logs of the thread are set (e.g. by discard_thread_output).
+
+    Purpose of the function: Schedules the allocation with every algorithm (DPS, EDF-VD, EDF-VD-DJ, EDF) with run_simulation and fresh statistics,
+                             EDF using the single criticality version of the taskset, as in commands.sh. The taskset is not modified.
+
+    Postconditions:
+        Output: {void}
+        Result: results[a] holds the completion flag of algorithm a and its times summed over the cores.
+*/
+void run_all_algorithms(task_set_struct *task_set, allocation_struct *allocation, simulation_result_struct *results)
+{
+    task_set_struct *sim_task_set;
+    simulation_result_struct *result;
+    int num_algo, num_core;
+
+    for (num_algo = 0; num_algo < NUM_ALGORITHMS; num_algo++)
+    {
+        result = &results[num_algo];
+        sim_task_set = (simulation_algorithms[num_algo] == EDF) ? derive_single_criticality_taskset(task_set) : task_set;
+
+        initialize_stats_struct();
+        result->completed = run_simulation(sim_task_set, allocation, simulation_algorithms[num_algo]);
+        result->active_time = result->idle_time = result->shutdown_time = result->discarded_exec = result->discarded_avail = 0.00;
+        for (num_core = 0; num_core < NUM_CORES; num_core++)
+        {
+            result->active_time += stats->total_active_energy[num_core];
+            result->idle_time += stats->total_idle_energy[num_core];
+            result->shutdown_time += stats->total_shutdown_time[num_core];
+            result->discarded_exec += stats->total_discarded_jobs_executed[num_core];
+            result->discarded_avail += stats->total_discarded_jobs_available[num_core];
+        }
+        free_stats_struct(stats);
+        stats = NULL;
+
+        if (sim_task_set != task_set)
+            free_generated_taskset(sim_task_set, 0);
+    }
+}
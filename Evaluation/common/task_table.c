@@ -0,0 +1,201 @@
+#include "functions.h"
+
+#if defined(__AVX2__) || defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+    Preconditions:
+        Input: {pointer to taskset}
+                task_set!=NULL
+                task_set->core_index!=NULL
+
+    Purpose of the function: Builds the task table (structure of arrays) of each core from the task index of the core.
+                             The tasks of the core are stored in increasing order of criticality level, and in increasing order of task number within a level,
+                             so that the tasks with criticality level >= l are the contiguous range [level_start[l], num_tasks).
+                             It must be called once the virtual deadlines of all the tasks are set.
+
+    Postconditions:
+        Output: {void}
+        Result: task_set->core_table contains NUM_CORES task tables and task_list[i].table_index is the position of task i in the table of its core.
+*/
+void build_task_table(task_set_struct *task_set)
+{
+    int num_core, crit_level, num_task, pos, task_number;
+    task_index_struct *index;
+    task_table_struct *table;
+
+    task_set->core_table = malloc(sizeof(task_table_struct) * NUM_CORES);
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        index = &(task_set->core_index[num_core]);
+        table = &(task_set->core_table[num_core]);
+
+        table->num_tasks = 0;
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            table->num_tasks += index->num_tasks[crit_level];
+        }
+
+        table->level_start = malloc(sizeof(int) * (MAX_CRITICALITY_LEVELS + 1));
+        table->task_number = malloc(sizeof(int) * max_int(table->num_tasks, 1));
+        table->phase = malloc(sizeof(double) * max_int(table->num_tasks, 1));
+        table->period = malloc(sizeof(double) * max_int(table->num_tasks, 1));
+        table->job_number = malloc(sizeof(double) * max_int(table->num_tasks, 1));
+        table->virtual_deadline = malloc(sizeof(double) * max_int(table->num_tasks, 1));
+        table->WCET = malloc(sizeof(double) * max_int(table->num_tasks, 1));
+        table->util = malloc(sizeof(double) * max_int(table->num_tasks, 1) * MAX_CRITICALITY_LEVELS);
+
+        pos = 0;
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            table->level_start[crit_level] = pos;
+            for (num_task = 0; num_task < index->num_tasks[crit_level]; num_task++)
+            {
+                task_number = index->task_list[crit_level][num_task];
+                task_set->task_list[task_number].table_index = pos;
+
+                table->task_number[pos] = task_number;
+                table->phase[pos] = task_set->task_list[task_number].phase;
+                table->period[pos] = task_set->task_list[task_number].period;
+                table->job_number[pos] = task_set->task_list[task_number].job_number;
+                table->virtual_deadline[pos] = task_set->task_list[task_number].virtual_deadline;
+                table->WCET[pos] = task_set->task_list[task_number].WCET[crit_level];
+                memcpy(&(table->util[pos * MAX_CRITICALITY_LEVELS]), task_set->task_list[task_number].util, sizeof(double) * MAX_CRITICALITY_LEVELS);
+                pos++;
+            }
+        }
+        table->level_start[MAX_CRITICALITY_LEVELS] = pos;
+    }
+
+    return;
+}
+
+/*
+    Function to copy the fields of a task which change at runtime (job number and virtual deadline) into the task table of its core.
+    It does nothing if the task tables are not built yet.
+*/
+void update_task_table(task_set_struct *task_set, int task_number)
+{
+    task *curr_task = &(task_set->task_list[task_number]);
+    task_table_struct *table;
+
+    if (task_set->core_table == NULL || curr_task->core < 0 || curr_task->core >= NUM_CORES)
+        return;
+
+    table = &(task_set->core_table[curr_task->core]);
+    table->job_number[curr_task->table_index] = curr_task->job_number;
+    table->virtual_deadline[curr_task->table_index] = curr_task->virtual_deadline;
+
+    return;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the task table of a core, range of positions [start, end) in the table}
+                table!=NULL
+
+    Purpose of the function: Computes the next release time (phase + period * job_number) of every task in the range and returns the earliest one.
+                             The kernel processes 4 tasks at a time with AVX, 2 tasks at a time with SSE2 and falls back to a scalar loop otherwise.
+                             The multiplication and the addition are done separately, so the result is the same as the scalar computation.
+
+    Postconditions:
+        Output: {The earliest next release time of the range, INT_MAX if the range is empty}
+*/
+double find_min_next_release(task_table_struct *table, int start, int end)
+{
+    double min_release = INT_MAX;
+    int i = start;
+
+#if defined(__AVX2__) || defined(__AVX__)
+    if (end - i >= 4)
+    {
+        __m256d min_vec = _mm256_set1_pd(INT_MAX);
+        double lanes[4];
+
+        for (; i + 4 <= end; i += 4)
+        {
+            __m256d release = _mm256_add_pd(_mm256_loadu_pd(&(table->phase[i])),
+                                            _mm256_mul_pd(_mm256_loadu_pd(&(table->period[i])), _mm256_loadu_pd(&(table->job_number[i]))));
+            min_vec = _mm256_min_pd(min_vec, release);
+        }
+        _mm256_storeu_pd(lanes, min_vec);
+        min_release = min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3]));
+    }
+#elif defined(__SSE2__)
+    if (end - i >= 2)
+    {
+        __m128d min_vec = _mm_set1_pd(INT_MAX);
+        double lanes[2];
+
+        for (; i + 2 <= end; i += 2)
+        {
+            __m128d release = _mm_add_pd(_mm_loadu_pd(&(table->phase[i])),
+                                         _mm_mul_pd(_mm_loadu_pd(&(table->period[i])), _mm_loadu_pd(&(table->job_number[i]))));
+            min_vec = _mm_min_pd(min_vec, release);
+        }
+        _mm_storeu_pd(lanes, min_vec);
+        min_release = min(lanes[0], lanes[1]);
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        min_release = min(min_release, table->phase[i] + table->period[i] * table->job_number[i]);
+    }
+
+    return min_release;
+}
+
+/*
+    Function to find the first job (starting from the current job number) of the task at position pos of the table which is released at or after time (inclusive = 1)
+    or strictly after time (inclusive = 0). The job number is computed arithmetically and then corrected, so that it is the same as stepping job by job.
+*/
+int find_next_job_number(task_table_struct *table, int pos, double time, int inclusive)
+{
+    double phase = table->phase[pos], period = table->period[pos];
+    int first_job = (int)table->job_number[pos];
+    int job_number;
+
+    job_number = (int)ceil((time - phase) / period);
+    if (job_number < first_job)
+        job_number = first_job;
+
+    //Correct the estimate for rounding errors in the division.
+    while (job_number > first_job && (inclusive ? (phase + period * (job_number - 1) >= time) : (phase + period * (job_number - 1) > time)))
+        job_number--;
+    while (inclusive ? (phase + period * job_number < time) : (phase + period * job_number <= time))
+        job_number++;
+
+    return job_number;
+}
+
+/*
+    Function to free the task table of every core.
+*/
+void free_task_table(task_set_struct *task_set)
+{
+    int num_core;
+    task_table_struct *table;
+
+    if (task_set->core_table == NULL)
+        return;
+
+    for (num_core = 0; num_core < NUM_CORES; num_core++)
+    {
+        table = &(task_set->core_table[num_core]);
+        free(table->level_start);
+        free(table->task_number);
+        free(table->phase);
+        free(table->period);
+        free(table->job_number);
+        free(table->virtual_deadline);
+        free(table->WCET);
+        free(table->util);
+    }
+    free(task_set->core_table);
+    task_set->core_table = NULL;
+    return;
+}
@@ -0,0 +1,617 @@
+#include "functions.h"
+
+//Period sets of the generator. The hyperperiod of the harmonic set is 1600 and that of the non-harmonic set is 2400.
+static const double harmonic_periods[] = {25, 50, 100, 200, 400, 800, 1600};
+static const double non_harmonic_periods[] = {20, 40, 60, 80, 100, 120, 160, 200};
+
+//Magic number at the start of each taskset in the binary format ("MCTS").
+#define TASKSET_MAGIC 0x5354434D
+
+/*
+    Function to mix the bits of a 64 bit value (finalizer of SplitMix64).
+*/
+static unsigned long long mix64(unsigned long long z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*
+    Function to initialize a random number generator from a seed.
+*/
+rng_struct rng_init(unsigned long long seed)
+{
+    rng_struct rng;
+    rng.state = mix64(seed + 0x9E3779B97F4A7C15ULL);
+    return rng;
+}
+
+/*
+    Function to derive the independent stream number stream of a generator. The generator itself is not advanced.
+*/
+rng_struct rng_split(rng_struct *rng, unsigned long long stream)
+{
+    rng_struct split;
+    split.state = mix64(rng->state ^ mix64(stream + 0x632BE59BD9B4E019ULL));
+    return split;
+}
+
+/*
+    Function to get the next 64 bit random number of a generator.
+*/
+unsigned long long rng_next(rng_struct *rng)
+{
+    rng->state += 0x9E3779B97F4A7C15ULL;
+    return mix64(rng->state);
+}
+
+/*
+    Function to get a random number uniformly distributed in [0, 1).
+*/
+double rng_uniform(rng_struct *rng)
+{
+    return (rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the generator parameters, number of tasks, HARMONIC_PERIODS or NON_HARMONIC_PERIODS}
+
+    Purpose of the function: Sets the default parameters of the generator: MAX_CRITICALITY_LEVELS levels, a WCET growth factor of 1.25 per level
+                             and 1000 UUniFast draws per taskset.
+
+    Postconditions:
+        Output: {void}
+*/
+void initialize_generator_struct(generator_struct *generator, int num_tasks, int period_set)
+{
+    int crit_level;
+
+    generator->num_tasks = num_tasks;
+    generator->num_levels = min_int(MAX_CRITICALITY_LEVELS, MAX_GENERATOR_LEVELS);
+    if (period_set == HARMONIC_PERIODS)
+    {
+        generator->periods = harmonic_periods;
+        generator->num_periods = sizeof(harmonic_periods) / sizeof(harmonic_periods[0]);
+    }
+    else
+    {
+        generator->periods = non_harmonic_periods;
+        generator->num_periods = sizeof(non_harmonic_periods) / sizeof(non_harmonic_periods[0]);
+    }
+    for (crit_level = 0; crit_level < MAX_GENERATOR_LEVELS; crit_level++)
+    {
+        generator->wcet_growth[crit_level] = 1.25;
+    }
+    generator->max_attempts = 1000;
+}
+
+/*
+    Function to draw a period log-uniformly between the smallest and the largest period of the set, rounded in log scale to the closest period of the set.
+*/
+static double generate_period(generator_struct *generator, rng_struct *rng)
+{
+    double log_min = log(generator->periods[0]);
+    double log_max = log(generator->periods[generator->num_periods - 1]);
+    double log_period = log_min + rng_uniform(rng) * (log_max - log_min);
+    int i;
+
+    for (i = 0; i < generator->num_periods - 1; i++)
+    {
+        if (log_period < 0.5 * (log(generator->periods[i]) + log(generator->periods[i + 1])))
+            break;
+    }
+    return generator->periods[i];
+}
+
+/*
+    Preconditions:
+        Input: {number of tasks, total utilisation, growth of the utilisation of each task at its own criticality level, array for the result, generator}
+
+    Purpose of the function: UUniFast-discard. Splits the total utilisation uniformly among the tasks, and discards the draw if a task would have
+                             a utilisation greater than 1 at its own criticality level.
+
+    Postconditions:
+        Output: {1 if the draw is accepted, 0 if it is discarded}
+*/
+static int uunifast(int num_tasks, double total_util, double growth[], double util[], rng_struct *rng)
+{
+    double sum_util = total_util, next_sum_util;
+    int i;
+
+    for (i = 0; i < num_tasks - 1; i++)
+    {
+        next_sum_util = sum_util * pow(rng_uniform(rng), 1.0 / (num_tasks - i - 1));
+        util[i] = sum_util - next_sum_util;
+        sum_util = next_sum_util;
+    }
+    util[num_tasks - 1] = sum_util;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        if (util[i] * growth[i] > 1.00)
+            return 0;
+    }
+    return 1;
+}
+
+/*
+    Function to generate the execution time of a job, as in create_times.c. A job of a task with criticality level higher than the current level
+    exceeds its WCET at the current level with probability 1/1024 (at most 3 times per taskset), otherwise the job finishes 1 unit before its WCET.
+    An overrunning job executes for 1 unit more than its WCET at the current level, but never more than its WCET at its own criticality level.
+*/
+static double generate_execution_time(task *curr_task, int curr_crit_lvl, int *crit_changes, rng_struct *rng)
+{
+    double WCET = curr_task->WCET[curr_crit_lvl];
+    double max_WCET = curr_task->WCET[curr_task->criticality_lvl];
+
+    if (curr_task->criticality_lvl > curr_crit_lvl && max_WCET > WCET && (rng_next(rng) & 1023) == 0 && *crit_changes < 3)
+    {
+        (*crit_changes)++;
+        return min(WCET + 1, max_WCET);
+    }
+    return max(1.00, WCET - 1);
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the taskset, generator}
+
+    Purpose of the function: Generates the execution times of the jobs of one hyperperiod of every task without an execution time model, as in create_times.c,
+                             and stores them in new arrays. The jobs are generated in the order of their job number, and the current criticality level increases
+                             whenever a job exceeds its WCET. The tasks with a model get the stream task_number of the generator; their execution times are drawn
+                             when needed by find_job_execution_time.
+                             The same generator state always gives the same execution times, so each stream of a generator is one realization.
+
+    Postconditions:
+        Output: {void}
+        Result: The exec_times of every task without a model point to a new array, which has to be freed by the caller. The exec_times of the other tasks are NULL.
+*/
+void generate_execution_times(task_set_struct *task_set, rng_struct *rng)
+{
+    double hyperperiod = find_superhyperperiod(task_set);
+    int i, j, curr_crit_level = 0, crit_changes = 0, max_jobs = 0;
+    task *curr_task;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        curr_task = &(task_set->task_list[i]);
+        curr_task->exec_cache = NULL;
+        curr_task->exec_prefix = NULL;
+        curr_task->exec_batch = -1;
+        if (curr_task->exec_model != NULL)
+        {
+            curr_task->exec_times = NULL;
+            curr_task->exec_rng = rng_split(rng, curr_task->task_number);
+            continue;
+        }
+
+        int num_jobs = hyperperiod / curr_task->period;
+        curr_task->exec_times = malloc(sizeof(double) * num_jobs);
+        max_jobs = max_int(max_jobs, num_jobs);
+    }
+
+    for (j = 0; j < max_jobs; j++)
+    {
+        for (i = 0; i < task_set->total_tasks; i++)
+        {
+            curr_task = &(task_set->task_list[i]);
+            if (curr_task->exec_model != NULL || j >= hyperperiod / curr_task->period)
+                continue;
+
+            curr_task->exec_times[j] = generate_execution_time(curr_task, curr_crit_level, &crit_changes, rng);
+            if (curr_task->exec_times[j] > curr_task->WCET[curr_crit_level])
+                curr_crit_level = min_int(curr_crit_level + 1, MAX_CRITICALITY_LEVELS - 1);
+        }
+    }
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the generator parameters, normalized utilisation (total utilisation at the lowest criticality level / NUM_CORES), generator}
+                generator->num_levels <= MAX_CRITICALITY_LEVELS, 0 < utilisation
+
+    Purpose of the function: Generates a taskset in memory, in the same format as get_taskset reads from input_mcs.txt and input_times.txt.
+                             The utilisations at the lowest level are drawn with UUniFast-discard, the periods log-uniformly from the period set and the
+                             criticality levels uniformly. The WCET at level l is the WCET at level l - 1 times wcet_growth[l] for the tasks with criticality level >= l.
+                             The WCETs are rounded to 2 decimals, as in the input files, and are at least 1.
+                             The execution times of the jobs of one hyperperiod are generated with generate_execution_times.
+                             The same generator state always gives the same taskset.
+
+    Postconditions:
+        Output: {Pointer to the taskset, sorted by period and with no task allocated. NULL if no draw was accepted in generator->max_attempts draws}
+*/
+task_set_struct *generate_taskset(generator_struct *generator, double utilisation, rng_struct *rng)
+{
+    int num_tasks = generator->num_tasks;
+    double util[num_tasks], growth[num_tasks], period[num_tasks];
+    int crit[num_tasks];
+    int i, attempt, crit_level;
+    task_set_struct *task_set;
+    task *curr_task;
+
+    for (attempt = 0; attempt < generator->max_attempts; attempt++)
+    {
+        for (i = 0; i < num_tasks; i++)
+        {
+            period[i] = generate_period(generator, rng);
+            crit[i] = rng_next(rng) % generator->num_levels;
+            growth[i] = 1.00;
+            for (crit_level = 1; crit_level <= crit[i]; crit_level++)
+            {
+                growth[i] *= generator->wcet_growth[crit_level];
+            }
+        }
+        if (uunifast(num_tasks, utilisation * NUM_CORES, growth, util, rng))
+            break;
+    }
+    if (attempt == generator->max_attempts)
+        return NULL;
+
+    task_set = malloc(sizeof(task_set_struct));
+    task_set->total_tasks = num_tasks;
+    task_set->task_list = malloc(sizeof(task) * num_tasks);
+    task_set->core_index = NULL;
+    task_set->core_table = NULL;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        curr_task = &(task_set->task_list[i]);
+        curr_task->phase = 0.00;
+        curr_task->period = period[i];
+        curr_task->relative_deadline = curr_task->period;
+        curr_task->criticality_lvl = crit[i];
+        curr_task->task_number = i;
+        curr_task->job_number = 0;
+        curr_task->core = -1;
+        curr_task->exec_model = NULL;
+        curr_task->trace = NULL;
+        curr_task->deadline_factor = 0.00;
+        curr_task->WCET = malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+        curr_task->util = malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+
+        curr_task->WCET[0] = max(1.00, round(100 * util[i] * curr_task->period) / 100);
+        for (crit_level = 1; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            curr_task->WCET[crit_level] = curr_task->WCET[crit_level - 1];
+            if (crit_level <= curr_task->criticality_lvl)
+                curr_task->WCET[crit_level] = min(curr_task->period, round(100 * curr_task->WCET[crit_level] * generator->wcet_growth[crit_level]) / 100);
+        }
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            curr_task->util[crit_level] = curr_task->WCET[crit_level] / curr_task->period;
+        }
+    }
+
+    generate_execution_times(task_set, rng);
+
+    //Sort the tasks list based on their periods, as done by get_taskset.
+    qsort((void *)task_set->task_list, num_tasks, sizeof(task_set->task_list[0]), period_comparator);
+
+    return task_set;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to a mixed-criticality taskset}
+
+    Purpose of the function: Creates the single criticality version of the taskset used by EDF (input_rts.txt): every task has criticality level 0 and its WCET at
+                             every level is its WCET at the highest level. The execution times are shared with the original taskset.
+                             The number of criticality levels is not changed, so the taskset can be scheduled in the same process as the mixed-criticality one.
+
+    Postconditions:
+        Output: {Pointer to the single criticality taskset}
+*/
+task_set_struct *derive_single_criticality_taskset(task_set_struct *task_set)
+{
+    task_set_struct *rts = copy_task_set(task_set);
+    int i, crit_level;
+    task *curr_task;
+
+    for (i = 0; i < rts->total_tasks; i++)
+    {
+        curr_task = &(rts->task_list[i]);
+        curr_task->criticality_lvl = 0;
+        curr_task->WCET = malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+        curr_task->util = malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            curr_task->WCET[crit_level] = task_set->task_list[i].WCET[MAX_CRITICALITY_LEVELS - 1];
+            curr_task->util[crit_level] = curr_task->WCET[crit_level] / curr_task->period;
+        }
+    }
+
+    return rts;
+}
+
+/*
+    Function to free a taskset created by generate_taskset or read_taskset_binary (with free_exec_times = 1) or by derive_single_criticality_taskset (with free_exec_times = 0).
+*/
+void free_generated_taskset(task_set_struct *task_set, int free_exec_times)
+{
+    int i;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        free(task_set->task_list[i].WCET);
+        free(task_set->task_list[i].util);
+        if (free_exec_times)
+            free(task_set->task_list[i].exec_times);
+        free(task_set->task_list[i].exec_cache);
+        free(task_set->task_list[i].exec_prefix);
+        free_trace(task_set->task_list[i].trace);
+    }
+    free_task_table(task_set);
+    free_task_index(task_set);
+    free(task_set->task_list);
+    free(task_set);
+}
+
+/*
+    Preconditions:
+        Input: {file pointer opened in binary mode, pointer to the taskset}
+
+    Purpose of the function: Appends the taskset to the file in the binary format: the magic number, the number of tasks and of criticality levels (int),
+                             then the arrays of phases, periods (double), criticality levels (int), WCETs (double, MAX_CRITICALITY_LEVELS per task),
+                             numbers of jobs (int) and the execution times of all the jobs (double), each written with one fwrite.
+                             The number of jobs of each task is the hyperperiod divided by its period.
+
+    Postconditions:
+        Output: {1 if the taskset was written, else 0}
+*/
+int write_taskset_binary(FILE *file, task_set_struct *task_set)
+{
+    int num_tasks = task_set->total_tasks, levels = MAX_CRITICALITY_LEVELS;
+    int header[3] = {TASKSET_MAGIC, num_tasks, levels};
+    double phase[num_tasks], period[num_tasks], WCET[num_tasks * levels], hyperperiod;
+    int crit[num_tasks], num_jobs[num_tasks];
+    int i, j, written = 1;
+
+    hyperperiod = find_superhyperperiod(task_set);
+    for (i = 0; i < num_tasks; i++)
+    {
+        phase[i] = task_set->task_list[i].phase;
+        period[i] = task_set->task_list[i].period;
+        crit[i] = task_set->task_list[i].criticality_lvl;
+        num_jobs[i] = hyperperiod / period[i];
+        memcpy(&WCET[i * levels], task_set->task_list[i].WCET, sizeof(double) * levels);
+    }
+
+    written &= fwrite(header, sizeof(int), 3, file) == 3;
+    written &= fwrite(phase, sizeof(double), num_tasks, file) == num_tasks;
+    written &= fwrite(period, sizeof(double), num_tasks, file) == num_tasks;
+    written &= fwrite(crit, sizeof(int), num_tasks, file) == num_tasks;
+    written &= fwrite(WCET, sizeof(double), num_tasks * levels, file) == num_tasks * levels;
+    written &= fwrite(num_jobs, sizeof(int), num_tasks, file) == num_tasks;
+    for (i = 0; i < num_tasks; i++)
+    {
+        double *times = task_set->task_list[i].exec_times;
+        if (times == NULL)
+        {
+            //The execution times of a task with a model are drawn now.
+            times = malloc(sizeof(double) * num_jobs[i]);
+            for (j = 0; j < num_jobs[i]; j++)
+            {
+                times[j] = find_job_execution_time(&(task_set->task_list[i]), j);
+            }
+        }
+        written &= fwrite(times, sizeof(double), num_jobs[i], file) == num_jobs[i];
+        if (times != task_set->task_list[i].exec_times)
+            free(times);
+    }
+
+    return written;
+}
+
+/*
+    Preconditions:
+        Input: {file pointer opened in binary mode, positioned at the start of a taskset}
+
+    Purpose of the function: Reads the next taskset written by write_taskset_binary.
+
+    Postconditions:
+        Output: {Pointer to the taskset, in the same form as returned by get_taskset. NULL at the end of the file, or if the taskset is not valid
+                 or was written with a different number of criticality levels}
+*/
+task_set_struct *read_taskset_binary(FILE *file)
+{
+    int header[3], num_tasks, levels = MAX_CRITICALITY_LEVELS, i, crit_level, valid = 1;
+    task_set_struct *task_set;
+    task *curr_task;
+
+    if (fread(header, sizeof(int), 3, file) != 3)
+        return NULL;
+    if (header[0] != TASKSET_MAGIC || header[1] <= 0 || header[2] != levels)
+    {
+        printf("ERROR: Invalid taskset in the binary file\n");
+        return NULL;
+    }
+
+    num_tasks = header[1];
+    double phase[num_tasks], period[num_tasks], WCET[num_tasks * levels];
+    int crit[num_tasks], num_jobs[num_tasks];
+
+    valid &= fread(phase, sizeof(double), num_tasks, file) == num_tasks;
+    valid &= fread(period, sizeof(double), num_tasks, file) == num_tasks;
+    valid &= fread(crit, sizeof(int), num_tasks, file) == num_tasks;
+    valid &= fread(WCET, sizeof(double), num_tasks * levels, file) == num_tasks * levels;
+    valid &= fread(num_jobs, sizeof(int), num_tasks, file) == num_tasks;
+    if (!valid)
+    {
+        printf("ERROR: Invalid taskset in the binary file\n");
+        return NULL;
+    }
+
+    task_set = malloc(sizeof(task_set_struct));
+    task_set->total_tasks = num_tasks;
+    task_set->task_list = malloc(sizeof(task) * num_tasks);
+    task_set->core_index = NULL;
+    task_set->core_table = NULL;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        curr_task = &(task_set->task_list[i]);
+        curr_task->phase = phase[i];
+        curr_task->period = period[i];
+        curr_task->relative_deadline = period[i];
+        curr_task->criticality_lvl = crit[i];
+        curr_task->task_number = i;
+        curr_task->job_number = 0;
+        curr_task->core = -1;
+        curr_task->exec_model = NULL;
+        curr_task->trace = NULL;
+        curr_task->exec_cache = NULL;
+        curr_task->exec_prefix = NULL;
+        curr_task->deadline_factor = 0.00;
+        curr_task->WCET = malloc(sizeof(double) * levels);
+        curr_task->util = malloc(sizeof(double) * levels);
+        for (crit_level = 0; crit_level < levels; crit_level++)
+        {
+            curr_task->WCET[crit_level] = WCET[i * levels + crit_level];
+            curr_task->util[crit_level] = curr_task->WCET[crit_level] / curr_task->period;
+        }
+        curr_task->exec_times = malloc(sizeof(double) * num_jobs[i]);
+        valid &= fread(curr_task->exec_times, sizeof(double), num_jobs[i], file) == num_jobs[i];
+    }
+
+    if (!valid)
+    {
+        printf("ERROR: Invalid taskset in the binary file\n");
+        free_generated_taskset(task_set, 1);
+        return NULL;
+    }
+
+    return task_set;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the taskset, file pointer to the times file}
+
+    Purpose of the function: Writes the execution times of the jobs of one hyperperiod of every task in the format of input_times.txt, in the order of the
+                             task numbers (the order of the tasks in input_mcs.txt). The execution times of the tasks with a model are drawn now.
+
+    Postconditions:
+        Output: {void}
+*/
+void write_execution_times_text(task_set_struct *task_set, FILE *times_file)
+{
+    double hyperperiod = find_superhyperperiod(task_set);
+    task *ordered[task_set->total_tasks];
+    int i, j, num_jobs;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        ordered[task_set->task_list[i].task_number] = &(task_set->task_list[i]);
+    }
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        num_jobs = hyperperiod / ordered[i]->period;
+        fprintf(times_file, "%d ", num_jobs);
+        for (j = 0; j < num_jobs; j++)
+        {
+            fprintf(times_file, "%.2lf ", find_job_execution_time(ordered[i], j));
+        }
+        fprintf(times_file, "\n");
+    }
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the taskset, file pointers to the input files}
+
+    Purpose of the function: Writes the taskset in the format of input_mcs.txt, input_rts.txt (criticality level 0 and the WCET at the highest level)
+                             and input_times.txt, in the order of the task numbers, so that it can be scheduled by the algorithms.
+
+    Postconditions:
+        Output: {void}
+*/
+void write_taskset_text(task_set_struct *task_set, FILE *mcs_file, FILE *rts_file, FILE *times_file)
+{
+    task *ordered[task_set->total_tasks], *curr_task;
+    int i, crit_level;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        ordered[task_set->task_list[i].task_number] = &(task_set->task_list[i]);
+    }
+
+    fprintf(mcs_file, "%d\n", task_set->total_tasks);
+    fprintf(rts_file, "%d\n", task_set->total_tasks);
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        curr_task = ordered[i];
+
+        fprintf(mcs_file, "%.2lf %.2lf %d ", curr_task->phase, curr_task->period, curr_task->criticality_lvl);
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            fprintf(mcs_file, "%.2lf ", curr_task->WCET[crit_level]);
+        }
+        fprintf(mcs_file, "\n");
+
+        fprintf(rts_file, "%.2lf %.2lf 0 %.2lf \n", curr_task->phase, curr_task->period, curr_task->WCET[MAX_CRITICALITY_LEVELS - 1]);
+    }
+
+    write_execution_times_text(task_set, times_file);
+}
+
+/*
+    Preconditions:
+        Input: {file pointer to a taskset in the format of input_mcs.txt}
+
+    Purpose of the function: Reads the taskset as get_taskset does, but without the execution times, which are then generated with generate_execution_times.
+
+    Postconditions:
+        Output: {Pointer to the taskset, sorted by period, with exec_times NULL for every task. NULL if the file is not valid}
+*/
+task_set_struct *read_taskset_text(FILE *mcs_file)
+{
+    task_set_struct *task_set;
+    task *curr_task;
+    int num_tasks, i, crit_level;
+
+    if (fscanf(mcs_file, "%d", &num_tasks) != 1 || num_tasks <= 0)
+        return NULL;
+
+    task_set = malloc(sizeof(task_set_struct));
+    task_set->total_tasks = num_tasks;
+    task_set->task_list = malloc(sizeof(task) * num_tasks);
+    task_set->core_index = NULL;
+    task_set->core_table = NULL;
+
+    for (i = 0; i < num_tasks; i++)
+    {
+        curr_task = &(task_set->task_list[i]);
+        curr_task->WCET = malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+        curr_task->util = malloc(sizeof(double) * MAX_CRITICALITY_LEVELS);
+        curr_task->exec_times = NULL;
+        curr_task->exec_model = NULL;
+        curr_task->trace = NULL;
+        curr_task->exec_cache = NULL;
+        curr_task->exec_prefix = NULL;
+        curr_task->deadline_factor = 0.00;
+        if (fscanf(mcs_file, "%lf%lf%d", &curr_task->phase, &curr_task->relative_deadline, &curr_task->criticality_lvl) != 3)
+        {
+            task_set->total_tasks = i + 1;
+            free_generated_taskset(task_set, 0);
+            return NULL;
+        }
+
+        //As it is an implicit-deadline taskset, period = deadline.
+        curr_task->period = curr_task->relative_deadline;
+        curr_task->task_number = i;
+        curr_task->job_number = 0;
+        curr_task->core = -1;
+        for (crit_level = 0; crit_level < MAX_CRITICALITY_LEVELS; crit_level++)
+        {
+            fscanf(mcs_file, "%lf", &curr_task->WCET[crit_level]);
+            curr_task->util[crit_level] = curr_task->WCET[crit_level] / curr_task->period;
+        }
+    }
+
+    qsort((void *)task_set->task_list, num_tasks, sizeof(task_set->task_list[0]), period_comparator);
+
+    return task_set;
+}
@@ -0,0 +1,368 @@
+#include "functions.h"
+
+/*
+    Function to create the trace of a task. The file is opened at the first access.
+*/
+trace_struct *create_trace(const char *path)
+{
+    trace_struct *trace = malloc(sizeof(trace_struct));
+
+    trace->path = malloc(strlen(path) + 1);
+    strcpy(trace->path, path);
+    trace->task_filter = -1;
+    trace->reader = NULL;
+    trace->file = NULL;
+    trace->buffer_size = TRACE_BUFFER_SIZE;
+    trace->buffer = malloc(sizeof(double) * trace->buffer_size);
+    trace->first_job = 0;
+    trace->num_buffered = 0;
+    trace->length = 0;
+    trace->num_read = 0;
+
+    return trace;
+}
+
+/*
+    Function to create the shared reader of an interleaved trace for a taskset of num_tasks tasks. The file is opened at the first access.
+*/
+static trace_reader_struct *create_trace_reader(const char *path, int num_tasks)
+{
+    trace_reader_struct *reader = malloc(sizeof(trace_reader_struct));
+    int num_task;
+
+    reader->path = malloc(strlen(path) + 1);
+    strcpy(reader->path, path);
+    reader->file = NULL;
+    reader->num_tasks = num_tasks;
+    reader->num_users = 0;
+    reader->traces = malloc(sizeof(trace_struct *) * num_tasks);
+    for (num_task = 0; num_task < num_tasks; num_task++)
+    {
+        reader->traces[num_task] = NULL;
+    }
+
+    return reader;
+}
+
+/*
+    Function to create the trace of task task_filter in the interleaved trace of the reader.
+*/
+static trace_struct *create_interleaved_trace(trace_reader_struct *reader, int task_filter)
+{
+    trace_struct *trace = create_trace(reader->path);
+
+    trace->task_filter = task_filter;
+    trace->reader = reader;
+    reader->traces[task_filter] = trace;
+    reader->num_users++;
+
+    return trace;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the copy of a taskset, whose tasks still point to the traces of the original taskset}
+
+    Purpose of the function: Creates new readers of the traces for the copy of the taskset, e.g. for a copy which is simulated by another thread.
+                             The interleaved traces of the copy share one new reader, as the ones of the original taskset.
+
+    Postconditions:
+        Output: {void}
+        Result: The traces of the tasks of the copy are new traces, read from their first job.
+*/
+void copy_traces(task_set_struct *task_set)
+{
+    trace_reader_struct *reader = NULL;
+    trace_struct *trace;
+    int i;
+
+    for (i = 0; i < task_set->total_tasks; i++)
+    {
+        trace = task_set->task_list[i].trace;
+        if (trace == NULL)
+            continue;
+
+        if (trace->reader == NULL)
+        {
+            task_set->task_list[i].trace = create_trace(trace->path);
+            continue;
+        }
+
+        //load_traces creates one reader for all the interleaved traces of a taskset.
+        if (reader == NULL)
+            reader = create_trace_reader(trace->reader->path, trace->reader->num_tasks);
+        task_set->task_list[i].trace = create_interleaved_trace(reader, trace->task_filter);
+    }
+}
+
+/*
+    Function to close and free a trace. The reader of an interleaved trace is freed with its last trace.
+*/
+void free_trace(trace_struct *trace)
+{
+    trace_reader_struct *reader;
+
+    if (trace == NULL)
+        return;
+
+    reader = trace->reader;
+    if (reader != NULL)
+    {
+        reader->traces[trace->task_filter] = NULL;
+        reader->num_users--;
+        if (reader->num_users == 0)
+        {
+            if (reader->file != NULL)
+                fclose(reader->file);
+            free(reader->traces);
+            free(reader->path);
+            free(reader);
+        }
+    }
+
+    if (trace->file != NULL)
+        fclose(trace->file);
+    free(trace->buffer);
+    free(trace->path);
+    free(trace);
+}
+
+/*
+    Preconditions:
+        Input: {file pointer to the list of traces, pointer to the taskset, before the tasks are sorted}
+
+    Purpose of the function: Reads the traces from which the execution times are replayed (../input_traces.txt). The file has either one line per task
+                             with the path of the trace of the task, in the order of the tasks in the input file, or the single line "interleaved <path>"
+                             for one trace with the lines "task_number execution_time" of all the tasks. Every trace is checked to be readable and
+                             to hold at least one execution time.
+
+    Postconditions:
+        Output: {1 if all the traces can be read, else 0 after printing the trace which cannot be read}
+        Result: The trace of each task is set and its exec_times is NULL.
+*/
+int load_traces(FILE *traces_file, task_set_struct *task_set)
+{
+    trace_reader_struct *reader = NULL;
+    char path[256];
+    double value;
+    int num_task, task_number;
+    FILE *file;
+
+    if (fscanf(traces_file, "%255s", path) != 1)
+    {
+        printf("ERROR: No trace listed in ../input_traces.txt\n");
+        return 0;
+    }
+
+    if (strcmp(path, "interleaved") == 0)
+    {
+        if (fscanf(traces_file, "%255s", path) != 1 || (file = fopen(path, "r")) == NULL)
+        {
+            printf("ERROR: Cannot open the interleaved trace listed in ../input_traces.txt\n");
+            return 0;
+        }
+        if (fscanf(file, "%d%lf", &task_number, &value) != 2)
+        {
+            printf("ERROR: The interleaved trace %s is empty\n", path);
+            fclose(file);
+            return 0;
+        }
+        fclose(file);
+
+        reader = create_trace_reader(path, task_set->total_tasks);
+    }
+
+    for (num_task = 0; num_task < task_set->total_tasks; num_task++)
+    {
+        task_set->task_list[num_task].exec_times = NULL;
+        if (reader != NULL)
+        {
+            task_set->task_list[num_task].trace = create_interleaved_trace(reader, num_task);
+            continue;
+        }
+
+        if (num_task > 0 && fscanf(traces_file, "%255s", path) != 1)
+        {
+            printf("ERROR: No trace listed for task %d in ../input_traces.txt\n", num_task);
+            return 0;
+        }
+        if ((file = fopen(path, "r")) == NULL)
+        {
+            printf("ERROR: Cannot open the trace %s of task %d\n", path, num_task);
+            return 0;
+        }
+        if (fscanf(file, "%lf", &value) != 1)
+        {
+            printf("ERROR: The trace %s of task %d is empty\n", path, num_task);
+            fclose(file);
+            return 0;
+        }
+        fclose(file);
+
+        task_set->task_list[num_task].trace = create_trace(path);
+    }
+
+    return 1;
+}
+
+/*
+    Function to stop the simulation when a trace, checked by load_traces, cannot be read anymore. A missing execution time would silently be replayed as 0.
+*/
+static void fail_trace(trace_struct *trace, const char *reason)
+{
+    if (trace->task_filter < 0)
+        printf("ERROR: The trace %s %s\n", trace->path, reason);
+    else
+        printf("ERROR: The interleaved trace %s %s for task %d\n", trace->path, reason, trace->task_filter);
+    exit(1);
+}
+
+/*
+    Function to add the execution time of the next job of the task to its buffer, growing the buffer if it is full.
+*/
+static void append_trace_value(trace_struct *trace, double value)
+{
+    if (trace->num_buffered == trace->buffer_size)
+    {
+        trace->buffer_size *= 2;
+        trace->buffer = realloc(trace->buffer, sizeof(double) * trace->buffer_size);
+    }
+    trace->buffer[trace->num_buffered++] = value;
+    trace->num_read++;
+}
+
+/*
+    Function to restart the reading of an interleaved trace from its start. The buffered jobs of all the tasks are dropped.
+*/
+static void rewind_trace_reader(trace_reader_struct *reader)
+{
+    int num_task;
+
+    rewind(reader->file);
+    for (num_task = 0; num_task < reader->num_tasks; num_task++)
+    {
+        if (reader->traces[num_task] == NULL)
+            continue;
+        reader->traces[num_task]->first_job = 0;
+        reader->traces[num_task]->num_buffered = 0;
+        reader->traces[num_task]->num_read = 0;
+    }
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the trace of a task in an interleaved trace, whose buffered jobs are all before the requested job}
+
+    Purpose of the function: Reads the lines of the interleaved trace until the buffer of the task holds TRACE_BUFFER_SIZE jobs. The lines of the other tasks
+                             are appended to their buffers, so the file is read once for all the tasks. At the end of the file, the reading restarts from
+                             the start of the file and the job numbers continue, so the jobs of every task are replayed after the end of the trace.
+
+    Postconditions:
+        Output: {void}
+        Result: trace->num_buffered == TRACE_BUFFER_SIZE. The simulation is stopped if the trace has no line of the task.
+*/
+static void fill_interleaved_trace(trace_struct *trace)
+{
+    trace_reader_struct *reader = trace->reader;
+    double value;
+    int task_number, num_task;
+
+    while (trace->num_buffered < TRACE_BUFFER_SIZE)
+    {
+        if (fscanf(reader->file, "%d%lf", &task_number, &value) == 2)
+        {
+            //The lines of the tasks which are not in the taskset are skipped.
+            if (task_number >= 0 && task_number < reader->num_tasks && reader->traces[task_number] != NULL)
+                append_trace_value(reader->traces[task_number], value);
+            continue;
+        }
+
+        //End of the trace: the whole file has been read since the last rewind.
+        if (trace->num_read == 0)
+            fail_trace(trace, "has no line");
+        rewind(reader->file);
+        for (num_task = 0; num_task < reader->num_tasks; num_task++)
+        {
+            if (reader->traces[num_task] != NULL)
+                reader->traces[num_task]->num_read = 0;
+        }
+    }
+}
+
+/*
+    Function to fill the buffer of the trace of a single task with the next TRACE_BUFFER_SIZE jobs of the trace. Returns 0 at the end of the trace.
+*/
+static int fill_single_trace(trace_struct *trace)
+{
+    double value;
+
+    while (trace->num_buffered < TRACE_BUFFER_SIZE && fscanf(trace->file, "%lf", &value) == 1)
+    {
+        append_trace_value(trace, value);
+    }
+    return trace->num_buffered > 0;
+}
+
+/*
+    Preconditions:
+        Input: {pointer to the trace, job number}
+
+    Purpose of the function: Returns the execution time of the job from the trace. When the job is after the buffered jobs, the buffer is refilled with the next
+                             TRACE_BUFFER_SIZE jobs of the trace; the jobs are requested in increasing order during the simulation, so the trace is read once.
+                             A job before the buffered ones makes the trace be read again from the start (for an interleaved trace, for all the tasks).
+                             After the end of a trace, the jobs are replayed from the start of the trace.
+
+    Postconditions:
+        Output: {The execution time of the job}
+        Result: The simulation is stopped if the trace cannot be opened or has no job of the task.
+*/
+double find_trace_execution_time(trace_struct *trace, int job_number)
+{
+    trace_reader_struct *reader = trace->reader;
+
+    if (reader != NULL)
+    {
+        if (reader->file == NULL && (reader->file = fopen(reader->path, "r")) == NULL)
+            fail_trace(trace, "cannot be opened");
+
+        if (job_number < trace->first_job)
+            rewind_trace_reader(reader);
+        while (job_number >= trace->first_job + trace->num_buffered)
+        {
+            trace->first_job += trace->num_buffered;
+            trace->num_buffered = 0;
+            fill_interleaved_trace(trace);
+        }
+        return trace->buffer[job_number - trace->first_job];
+    }
+
+    if (trace->file == NULL && (trace->file = fopen(trace->path, "r")) == NULL)
+        fail_trace(trace, "cannot be opened");
+
+    if (trace->length > 0)
+        job_number %= trace->length;
+    if (job_number < trace->first_job)
+    {
+        rewind(trace->file);
+        trace->first_job = 0;
+        trace->num_buffered = 0;
+    }
+
+    while (job_number >= trace->first_job + trace->num_buffered)
+    {
+        trace->first_job += trace->num_buffered;
+        trace->num_buffered = 0;
+        if (!fill_single_trace(trace))
+        {
+            //End of the trace.
+            if (trace->first_job == 0)
+                fail_trace(trace, "is empty");
+            trace->length = trace->first_job;
+            job_number %= trace->length;
+            rewind(trace->file);
+            trace->first_job = 0;
+        }
+    }
+
+    return trace->buffer[job_number - trace->first_job];
+}
@@ -65,13 +65,14 @@ double gcd(double a, double b)
     return gcd(a, b - a);
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     FILE* fd = fopen("input_mcs.txt", "r");
     FILE* exec_file = fopen("input_times.txt", "w");
 
     crit_change = 0;
 
-    srand(time(NULL));
+    //The seed can be passed as argument (./create_times seed) to reproduce the execution times.
+    srand((argc > 1) ? (unsigned int)atoi(argv[1]) : time(NULL));
 
     int num_tasks;
     fscanf(fd, "%d", &num_tasks);